@@ -0,0 +1,88 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+class WRenderer;
+
+struct WBenchConfig
+{
+    std::vector<std::string> workloads = {"draws", "instances", "meshes", "uploads", "resize"};
+    /** Draws per frame for the draw workloads **/
+    uint32_t count = 1000;
+    uint32_t frames = 300;
+    uint32_t warmup_frames = 30;
+    uint32_t seed = 1;
+    uint32_t upload_mb = 64;
+    uint32_t upload_iterations = 16;
+    uint32_t resize_interval = 10;
+    bool headless = false;
+    /** Off records every draw on the cpu, to compare against the gpu driven path **/
+    bool gpu_culling = true;
+    uint32_t frames_in_flight = 2;
+    int width = 1280;
+    int height = 720;
+    /** Where the renderer writes its memory report at cleanup, with whatever was leaked. Empty skips it **/
+    std::string memory_report;
+};
+
+struct WBenchStats
+{
+    uint32_t sample_count = 0;
+    double min = 0.0;
+    double avg = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    static WBenchStats FromSamples(std::vector<double> samples);
+};
+
+struct WBenchResult
+{
+    std::string workload;
+    uint32_t count = 0;
+    uint32_t frames = 0;
+
+    WBenchStats frame_ms;
+    WBenchStats cpu_record_ms;
+    WBenchStats gpu_frame_ms;
+
+    uint64_t upload_bytes = 0;
+    WBenchStats upload_ms;
+    double upload_mb_per_s = 0.0;
+};
+
+/** Drives WRenderer through synthetic workloads, the same seed always produces the same scene **/
+class WBench
+{
+public:
+    explicit WBench(WBenchConfig _config);
+
+    std::vector<WBenchResult> Run();
+    [[nodiscard]] std::string ToJson(const std::vector<WBenchResult>& results) const;
+
+private:
+    WBenchConfig config;
+    WRenderer& renderer;
+    std::mt19937 rng;
+    std::string device_name;
+
+    WBenchResult run_draws(const std::string& workload, bool uniqueMeshes);
+    WBenchResult run_instances();
+    WBenchResult run_uploads();
+    WBenchResult run_resize();
+
+    /** Calls submitDraws before every frame, the warmup frames are not part of the result **/
+    template<typename SubmitDraws>
+    void measure_frames(WBenchResult& result, SubmitDraws submitDraws);
+
+    void poll_events() const;
+    void setup_camera() const;
+};
@@ -0,0 +1,90 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "WBench.h"
+
+static std::vector<std::string> splitList(const std::string_view list)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        const size_t end = std::min(list.find(',', start), list.size());
+        if (end > start)
+            items.emplace_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+int main(const int argc, char* argv[])
+{
+    WBenchConfig config;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--headless")
+            config.headless = true;
+        else if (arg == "--cpu-draws")
+            config.gpu_culling = false;
+        else if (arg == "--frames-in-flight" && hasValue)
+            config.frames_in_flight = std::stoul(argv[++i]);
+        else if (arg == "--workload" && hasValue)
+            config.workloads = splitList(argv[++i]);
+        else if (arg == "--count" && hasValue)
+            config.count = std::stoul(argv[++i]);
+        else if (arg == "--frames" && hasValue)
+            config.frames = std::stoul(argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            config.warmup_frames = std::stoul(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            config.seed = std::stoul(argv[++i]);
+        else if (arg == "--upload-mb" && hasValue)
+            config.upload_mb = std::stoul(argv[++i]);
+        else if (arg == "--upload-iterations" && hasValue)
+            config.upload_iterations = std::stoul(argv[++i]);
+        else if (arg == "--resize-interval" && hasValue)
+            config.resize_interval = std::stoul(argv[++i]);
+        else if (arg == "--width" && hasValue)
+            config.width = std::stoi(argv[++i]);
+        else if (arg == "--height" && hasValue)
+            config.height = std::stoi(argv[++i]);
+        else if (arg == "--memory-report" && hasValue)
+            config.memory_report = argv[++i];
+        else if (arg == "--out" && hasValue)
+            outputPath = argv[++i];
+        else
+        {
+            std::cerr << "unknown argument: " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    try
+    {
+        WBench bench(config);
+        const auto json = bench.ToJson(bench.Run());
+
+        std::cout << json;
+        if (!outputPath.empty())
+            std::ofstream(outputPath) << json;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
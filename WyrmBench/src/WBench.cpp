@@ -0,0 +1,396 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WBench.h"
+
+#include <WRenderer.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <sstream>
+#include <stdexcept>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(const Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static std::vector<Vertex> makePolygonVertices(const uint32_t sides, std::mt19937& rng)
+{
+    std::uniform_real_distribution radiusJitter(0.35f, 0.5f);
+    std::uniform_real_distribution channel(0.f, 1.f);
+
+    std::vector<Vertex> polygon;
+    polygon.reserve(sides + 1);
+    polygon.push_back({{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}, {0.5f, 0.5f}});
+    for (uint32_t i = 0; i < sides; i++)
+    {
+        const float angle = 2.f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(sides);
+        const float radius = radiusJitter(rng);
+        const glm::vec2 position(std::cos(angle) * radius, std::sin(angle) * radius);
+        polygon.push_back({glm::vec3(position, 0.f), {channel(rng), channel(rng), channel(rng)}, position + 0.5f});
+    }
+    return polygon;
+}
+
+static std::vector<uint32_t> makeFanIndices(const uint32_t sides)
+{
+    std::vector<uint32_t> fan;
+    fan.reserve(sides * 3);
+    for (uint32_t i = 0; i < sides; i++)
+    {
+        fan.push_back(0);
+        fan.push_back(1 + i);
+        fan.push_back(1 + (i + 1) % sides);
+    }
+    return fan;
+}
+
+static std::vector<glm::mat4> makeGridTransforms(const uint32_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution rotation(0.f, 2.f * std::numbers::pi_v<float>);
+
+    const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cell = 2.f / static_cast<float>(std::max(columns, 1u));
+
+    std::vector<glm::mat4> transforms;
+    transforms.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float x = -1.f + cell * (static_cast<float>(i % columns) + 0.5f);
+        const float y = -1.f + cell * (static_cast<float>(i / columns) + 0.5f);
+
+        auto transform = glm::translate(glm::mat4(1.f), glm::vec3(x, y, 0.f));
+        transform = glm::rotate(transform, rotation(rng), glm::vec3(0.f, 0.f, 1.f));
+        transforms.push_back(glm::scale(transform, glm::vec3(cell * 0.9f)));
+    }
+    return transforms;
+}
+
+static void writeStats(std::ostringstream& json, const char* name, const WBenchStats& stats)
+{
+    json << "      \"" << name << "\": {"
+         << "\"samples\": " << stats.sample_count
+         << ", \"min\": " << stats.min
+         << ", \"avg\": " << stats.avg
+         << ", \"p50\": " << stats.p50
+         << ", \"p90\": " << stats.p90
+         << ", \"p99\": " << stats.p99
+         << ", \"max\": " << stats.max
+         << "},\n";
+}
+
+static std::string escapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped.push_back('\\');
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+WBenchStats WBenchStats::FromSamples(std::vector<double> samples)
+{
+    WBenchStats stats {.sample_count = static_cast<uint32_t>(samples.size())};
+    if (samples.empty()) return stats;
+
+    std::ranges::sort(samples);
+    const auto percentile = [&samples](const double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    double total = 0.0;
+    for (const double sample : samples)
+        total += sample;
+
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.avg = total / static_cast<double>(samples.size());
+    stats.p50 = percentile(0.50);
+    stats.p90 = percentile(0.90);
+    stats.p99 = percentile(0.99);
+    return stats;
+}
+
+WBench::WBench(WBenchConfig _config) : config(std::move(_config)), renderer(WRenderer::GetInstance()), rng(config.seed)
+{}
+
+std::vector<WBenchResult> WBench::Run()
+{
+    for (const auto& workload : config.workloads)
+        if (workload != "draws" && workload != "instances" && workload != "meshes" && workload != "uploads" && workload != "resize")
+            throw std::runtime_error("unknown workload: " + workload);
+
+    renderer.SetHeadless(config.headless);
+    renderer.SetGpuCulling(config.gpu_culling);
+    renderer.SetFramesInFlight(config.frames_in_flight);
+    renderer.SetWindowSize(config.width, config.height);
+    if (!config.memory_report.empty())
+        renderer.SetMemoryReportPath(config.memory_report);
+    // the uploads workload creates one mesh of upload_mb at a time, the pool has to fit it next to the other workloads
+    const uint64_t uploadVertexCount = static_cast<uint64_t>(config.upload_mb) * 1024 * 1024 / sizeof(Vertex);
+    renderer.SetGeometryPoolCapacity(
+        static_cast<uint32_t>(std::max<uint64_t>(WGeometryPool::DEFAULT_VERTEX_CAPACITY, uploadVertexCount + WGeometryPool::DEFAULT_VERTEX_CAPACITY / 4)),
+        WGeometryPool::DEFAULT_INDEX_CAPACITY
+    );
+    renderer.InitWindow();
+    renderer.InitVulkan();
+    device_name = renderer.GetDeviceName();
+    setup_camera();
+
+    std::vector<WBenchResult> results;
+    for (const auto& workload : config.workloads)
+    {
+        // every workload starts from the same seed, so adding or reordering workloads doesn't change the others
+        rng.seed(config.seed);
+
+        if (workload == "draws")
+            results.push_back(run_draws(workload, false));
+        else if (workload == "instances")
+            results.push_back(run_instances());
+        else if (workload == "meshes")
+            results.push_back(run_draws(workload, true));
+        else if (workload == "uploads")
+            results.push_back(run_uploads());
+        else
+            results.push_back(run_resize());
+    }
+
+    renderer.Cleanup();
+    return results;
+}
+
+std::string WBench::ToJson(const std::vector<WBenchResult>& results) const
+{
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"benchmark\": \"WyrmBench\",\n"
+         << "  \"device\": \"" << escapeJson(device_name) << "\",\n"
+         << "  \"headless\": " << (config.headless ? "true" : "false") << ",\n"
+         << "  \"gpu_culling\": " << (config.gpu_culling ? "true" : "false") << ",\n"
+         << "  \"frames_in_flight\": " << config.frames_in_flight << ",\n"
+         << "  \"width\": " << config.width << ",\n"
+         << "  \"height\": " << config.height << ",\n"
+         << "  \"seed\": " << config.seed << ",\n"
+         << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto& result = results[i];
+        json << "    {\n"
+             << "      \"workload\": \"" << result.workload << "\",\n"
+             << "      \"count\": " << result.count << ",\n"
+             << "      \"frames\": " << result.frames << ",\n";
+        writeStats(json, "frame_ms", result.frame_ms);
+        writeStats(json, "cpu_record_ms", result.cpu_record_ms);
+        writeStats(json, "gpu_frame_ms", result.gpu_frame_ms);
+        writeStats(json, "upload_ms", result.upload_ms);
+        json << "      \"upload_bytes\": " << result.upload_bytes << ",\n"
+             << "      \"upload_mb_per_s\": " << result.upload_mb_per_s << "\n"
+             << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+WBenchResult WBench::run_draws(const std::string& workload, const bool uniqueMeshes)
+{
+    WBenchResult result {.workload = workload, .count = config.count, .frames = config.frames};
+
+    std::vector<WMeshHandle> meshes;
+    if (uniqueMeshes)
+    {
+        meshes.reserve(config.count);
+        for (uint32_t i = 0; i < config.count; i++)
+        {
+            const uint32_t sides = 3 + i % 29;
+            meshes.push_back(renderer.CreateMesh(makePolygonVertices(sides, rng), makeFanIndices(sides)));
+        }
+    }
+    else
+        meshes.push_back(renderer.CreateMesh(vertices, indices));
+
+    const auto transforms = makeGridTransforms(config.count, rng);
+    measure_frames(result, [&](uint32_t) {
+        for (uint32_t i = 0; i < config.count; i++)
+            renderer.Draw(meshes[uniqueMeshes ? i : 0], transforms[i]);
+    });
+
+    for (const auto mesh : meshes)
+        renderer.DestroyMesh(mesh);
+
+    return result;
+}
+
+WBenchResult WBench::run_instances()
+{
+    WBenchResult result {.workload = "instances", .count = config.count, .frames = config.frames};
+
+    const WMeshHandle quad = renderer.CreateMesh(vertices, indices);
+
+    // same grid as the draws workload, but submitted as one instanced draw
+    std::uniform_real_distribution channel(0.5f, 1.f);
+    std::vector<InstanceData> instances;
+    instances.reserve(config.count);
+    for (const auto& transform : makeGridTransforms(config.count, rng))
+        instances.push_back({transform, {channel(rng), channel(rng), channel(rng), 1.f}});
+
+    measure_frames(result, [&](uint32_t) {
+        renderer.DrawInstanced(quad, instances);
+    });
+
+    renderer.DestroyMesh(quad);
+    return result;
+}
+
+WBenchResult WBench::run_uploads()
+{
+    WBenchResult result {.workload = "uploads", .count = config.upload_iterations};
+
+    const size_t vertexCount = static_cast<size_t>(config.upload_mb) * 1024 * 1024 / sizeof(Vertex);
+    std::vector<Vertex> uploadVertices(vertexCount);
+    std::uniform_real_distribution value(-1.f, 1.f);
+    for (auto& vertex : uploadVertices)
+        vertex = {{value(rng), value(rng), value(rng)}, {value(rng), value(rng), value(rng)}, {value(rng), value(rng)}};
+
+    const std::vector<uint32_t> uploadIndices = {0, 1, 2};
+    const uint64_t bytesPerUpload = uploadVertices.size() * sizeof(Vertex) + uploadIndices.size() * sizeof(uint32_t);
+
+    renderer.WaitIdle();
+
+    std::vector<double> uploadTimes;
+    double totalMs = 0.0;
+    for (uint32_t i = 0; i < config.upload_iterations; i++)
+    {
+        const auto start = Clock::now();
+        const WMeshHandle mesh = renderer.CreateMesh(uploadVertices, uploadIndices);
+        renderer.WaitForUploads(renderer.FlushUploads());
+        const double ms = elapsedMs(start);
+
+        uploadTimes.push_back(ms);
+        totalMs += ms;
+        result.upload_bytes += bytesPerUpload;
+
+        // the pool only gets the range back once the deletion queue runs, and no frame is drawn in between
+        renderer.DestroyMesh(mesh);
+        renderer.WaitIdle();
+    }
+
+    result.upload_ms = WBenchStats::FromSamples(std::move(uploadTimes));
+    if (totalMs > 0.0)
+        result.upload_mb_per_s = static_cast<double>(result.upload_bytes) / (1024.0 * 1024.0) / (totalMs / 1000.0);
+
+    return result;
+}
+
+WBenchResult WBench::run_resize()
+{
+    WBenchResult result {.workload = "resize", .count = config.resize_interval, .frames = config.frames};
+
+    const WMeshHandle quad = renderer.CreateMesh(vertices, indices);
+    const int smallWidth = config.width * 3 / 4;
+    const int smallHeight = config.height * 3 / 4;
+
+    measure_frames(result, [&](const uint32_t frame) {
+        if (config.resize_interval > 0 && frame % config.resize_interval == 0)
+        {
+            const bool small = frame / config.resize_interval % 2 == 1;
+            const int resizeWidth = small ? smallWidth : config.width;
+            const int resizeHeight = small ? smallHeight : config.height;
+
+            if (config.headless)
+                renderer.SetWindowSize(resizeWidth, resizeHeight);
+            else
+            {
+                glfwSetWindowSize(renderer.GetWindow(), resizeWidth, resizeHeight);
+                glfwPollEvents();
+            }
+        }
+        renderer.Draw(quad, glm::mat4(1.f));
+    });
+
+    if (config.headless)
+        renderer.SetWindowSize(config.width, config.height);
+    else
+        glfwSetWindowSize(renderer.GetWindow(), config.width, config.height);
+
+    renderer.DestroyMesh(quad);
+    return result;
+}
+
+template<typename SubmitDraws>
+void WBench::measure_frames(WBenchResult& result, SubmitDraws submitDraws)
+{
+    for (uint32_t i = 0; i < config.warmup_frames; i++)
+    {
+        poll_events();
+        submitDraws(i);
+        renderer.DrawFrame();
+    }
+
+    const auto& profiler = renderer.GetProfiler();
+    const uint64_t firstFrame = profiler.GetNextFrameNumber();
+    uint64_t nextFrame = firstFrame;
+
+    std::vector<double> frameTimes, recordTimes, gpuTimes;
+    frameTimes.reserve(config.frames);
+
+    // the profiler ring is shorter than a run, so published frames are drained after every frame
+    const auto collect = [&](const uint64_t lastFrame) {
+        WFrameTimings timings;
+        for (; nextFrame < std::min(lastFrame, profiler.GetPublishedFrameCount()); nextFrame++)
+        {
+            if (!profiler.GetFrame(nextFrame, timings)) continue;
+
+            for (uint32_t zone = 0; zone < timings.cpu_zone_count; zone++)
+                if (strcmp(timings.cpu_zones[zone].name, "record") == 0)
+                    recordTimes.push_back(timings.cpu_zones[zone].milliseconds);
+
+            if (timings.gpu_scope_count > 0)
+                gpuTimes.push_back(timings.gpu_frame_ms);
+        }
+    };
+
+    for (uint32_t i = 0; i < config.frames; i++)
+    {
+        const auto start = Clock::now();
+        poll_events();
+        submitDraws(config.warmup_frames + i);
+        renderer.DrawFrame();
+        frameTimes.push_back(elapsedMs(start));
+
+        collect(firstFrame + config.frames);
+    }
+
+    // the last frames in flight are only resolved by later frames, so they are not part of the gpu and record samples
+    result.frame_ms = WBenchStats::FromSamples(std::move(frameTimes));
+    result.cpu_record_ms = WBenchStats::FromSamples(std::move(recordTimes));
+    result.gpu_frame_ms = WBenchStats::FromSamples(std::move(gpuTimes));
+}
+
+void WBench::poll_events() const
+{
+    if (!config.headless)
+        glfwPollEvents();
+}
+
+void WBench::setup_camera() const
+{
+    const float aspect = static_cast<float>(config.width) / static_cast<float>(config.height);
+    auto projection = glm::ortho(-aspect, aspect, -1.f, 1.f, -1.f, 1.f);
+    projection[1][1] *= -1;
+
+    renderer.SetCamera(glm::mat4(1.f), projection);
+}
@@ -0,0 +1,11 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <filesystem>
+
+#include "WMeshImport.h"
+
+/** Writes the header and part table followed by the aligned vertex and index blobs of every part, see WMeshFormat.h **/
+void writeCookedMesh(const WImportedMesh& mesh, const std::filesystem::path& path);
@@ -0,0 +1,39 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include <iostream>
+
+#include "WMeshCooker.h"
+
+int main(const int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: WyrmCooker <input.gltf|input.glb> <output.wmesh>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const WImportedMesh mesh = importGltf(argv[1]);
+        writeCookedMesh(mesh, argv[2]);
+
+        size_t vertexCount = 0;
+        size_t triangleCount = 0;
+        for (const auto& part : mesh.parts)
+        {
+            vertexCount += part.vertices.size();
+            triangleCount += part.indices.size() / 3;
+        }
+        std::cout << argv[2] << ": " << vertexCount << " vertices (" << mesh.source_vertex_count << " before deduplication), "
+            << triangleCount << " triangles in " << mesh.parts.size() << " parts" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WMeshCooker.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "WMeshFormat.h"
+
+void writeCookedMesh(const WImportedMesh& mesh, const std::filesystem::path& path)
+{
+    if (mesh.parts.empty())
+        throw std::runtime_error("can't cook a mesh without parts");
+
+    WMeshFileHeader header {.part_count = static_cast<uint32_t>(mesh.parts.size())};
+    header.parts_offset = alignMeshOffset(sizeof(WMeshFileHeader));
+
+    // the blobs follow the part table in part order
+    std::vector<WMeshFilePart> fileParts;
+    uint64_t offset = header.parts_offset + mesh.parts.size() * sizeof(WMeshFilePart);
+    for (const auto& part : mesh.parts)
+    {
+        WMeshFilePart& filePart = fileParts.emplace_back();
+        filePart.vertex_count = static_cast<uint32_t>(part.vertices.size());
+        filePart.index_count = static_cast<uint32_t>(part.indices.size());
+        filePart.vertex_offset = alignMeshOffset(offset);
+        filePart.index_offset = alignMeshOffset(filePart.vertex_offset + part.vertices.size() * sizeof(Vertex));
+        filePart.bounding_sphere = part.bounding_sphere;
+        offset = filePart.index_offset + part.indices.size() * sizeof(uint16_t);
+    }
+
+    header.bounds_min = header.bounds_max = mesh.parts.front().vertices.front().position;
+    for (const auto& part : mesh.parts)
+        for (const auto& vertex : part.vertices)
+        {
+            header.bounds_min = glm::min(header.bounds_min, vertex.position);
+            header.bounds_max = glm::max(header.bounds_max, vertex.position);
+        }
+    const glm::vec3 center = (header.bounds_min + header.bounds_max) * 0.5f;
+    float radius = 0.f;
+    for (const auto& part : mesh.parts)
+        for (const auto& vertex : part.vertices)
+            radius = std::max(radius, glm::length(vertex.position - center));
+    header.bounding_sphere = glm::vec4(center, radius);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error("failed to open " + path.string() + " for writing");
+
+    // the gaps up to the aligned offsets are written as zeros
+    constexpr char padding[WMESH_ALIGNMENT] {};
+    uint64_t written = 0;
+    const auto write = [&](const void* data, const uint64_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    const auto padTo = [&](const uint64_t target) {
+        file.write(padding, static_cast<std::streamsize>(target - written));
+        written = target;
+    };
+
+    write(&header, sizeof(header));
+    padTo(header.parts_offset);
+    write(fileParts.data(), fileParts.size() * sizeof(WMeshFilePart));
+    for (size_t i = 0; i < mesh.parts.size(); i++)
+    {
+        padTo(fileParts[i].vertex_offset);
+        write(mesh.parts[i].vertices.data(), mesh.parts[i].vertices.size() * sizeof(Vertex));
+        padTo(fileParts[i].index_offset);
+        write(mesh.parts[i].indices.data(), mesh.parts[i].indices.size() * sizeof(uint16_t));
+    }
+
+    if (!file)
+        throw std::runtime_error("failed to write " + path.string());
+}
@@ -0,0 +1,39 @@
+# Turns a SPIR-V binary into a header with the words as a constexpr uint32_t array.
+# Run in script mode: cmake -DINPUT=<spv> -DOUTPUT=<header> -DSYMBOL=<name> -P EmbedSpirv.cmake
+
+file(READ ${INPUT} bytes HEX)
+string(LENGTH "${bytes}" length)
+math(EXPR remainder "${length} % 8")
+if (length EQUAL 0 OR NOT remainder EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V binary")
+endif()
+
+# the file is little endian, so the bytes of every word are flipped into a literal
+string(REGEX MATCHALL "........" words "${bytes}")
+set(body "")
+set(column 0)
+foreach(word ${words})
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," literal ${word})
+    string(APPEND body " ${literal}")
+    math(EXPR column "${column} + 1")
+    if (column EQUAL 8)
+        string(APPEND body "\n   ")
+        set(column 0)
+    endif()
+endforeach()
+string(REGEX REPLACE "\n   $" "" body "${body}")
+
+get_filename_component(source ${INPUT} NAME)
+file(WRITE ${OUTPUT}.tmp
+"// generated from ${source}, do not edit
+#pragma once
+
+#include <cstdint>
+
+alignas(4) inline constexpr uint32_t ${SYMBOL}[] = {
+   ${body}
+};
+")
+# only touch the header when the code changed, everything that includes it rebuilds otherwise
+file(COPY_FILE ${OUTPUT}.tmp ${OUTPUT} ONLY_IF_DIFFERENT)
+file(REMOVE ${OUTPUT}.tmp)
@@ -0,0 +1,104 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "WVulkan.h"
+
+/** What an allocation is for, reports group the tracked bytes by it **/
+enum WAllocationCategory : uint32_t
+{
+    ALLOCATION_MESH,
+    ALLOCATION_UNIFORM,
+    ALLOCATION_STAGING,
+    ALLOCATION_TEXTURE,
+    ALLOCATION_RENDER_TARGET,
+    ALLOCATION_INDIRECT,
+    ALLOCATION_BUFFER,
+    ALLOCATION_IMAGE,
+    ALLOCATION_CATEGORY_COUNT
+};
+
+[[nodiscard]] const char* allocationCategoryName(WAllocationCategory category);
+
+struct WHeapStats
+{
+    bool device_local = false;
+    /** From VK_EXT_memory_budget where it's available, estimated by VMA otherwise **/
+    vk::DeviceSize budget = 0;
+    vk::DeviceSize usage = 0;
+    /** Device memory VMA allocated and the part of it handed out **/
+    vk::DeviceSize block_bytes = 0;
+    vk::DeviceSize allocation_bytes = 0;
+    uint32_t block_count = 0;
+    uint32_t allocation_count = 0;
+    /** 0 while the free space of the blocks is one range, towards 1 the more it's scattered **/
+    float fragmentation = 0.f;
+};
+
+struct WCategoryStats
+{
+    uint32_t allocation_count = 0;
+    vk::DeviceSize bytes = 0;
+};
+
+struct WMemoryStats
+{
+    std::vector<WHeapStats> heaps;
+    std::array<WCategoryStats, ALLOCATION_CATEGORY_COUNT> categories {};
+};
+
+/** Names every VMA allocation the renderer makes and counts it under a category, so memory growth can be traced back to its source.
+    Allocations are tracked from their creation until they're destroyed through DestroyBuffer or DestroyImage, whatever is
+    still tracked at shutdown is a leak. Thread safe. **/
+class WAllocationTracker
+{
+public:
+    struct Entry
+    {
+        WAllocationCategory category = ALLOCATION_BUFFER;
+        std::string name;
+        vk::DeviceSize size = 0;
+    };
+
+    WAllocationTracker() = default;
+    WAllocationTracker(const WAllocationTracker&) = delete;
+    WAllocationTracker& operator=(const WAllocationTracker&) = delete;
+
+    void Init(VmaAllocator _allocator);
+    /** Forgets whatever is still tracked, report the leaks first **/
+    void Destroy();
+
+    /** The name also shows up in VMA's own stats string as "<category>/<name>" **/
+    void Track(VmaAllocation allocation, WAllocationCategory category, std::string_view name);
+    void DestroyBuffer(vk::Buffer buffer, VmaAllocation allocation);
+    void DestroyImage(vk::Image image, VmaAllocation allocation);
+
+    /** Walks every VMA block, meant for reports and debug overlays rather than every frame **/
+    [[nodiscard]] WMemoryStats GetStats() const;
+    [[nodiscard]] uint32_t GetTrackedCount() const;
+    /** Every tracked allocation, e.g. to list what's left at shutdown **/
+    [[nodiscard]] std::vector<Entry> GetTracked() const;
+    [[nodiscard]] Entry Find(VmaAllocation allocation) const;
+
+    /** JSON with VMA's stats string under "vma", the per heap and per category numbers of GetStats and the given leaks.
+        Detailed includes VMA's map of every allocation by name **/
+    [[nodiscard]] std::string BuildReport(bool detailed, std::span<const Entry> leaks = {}) const;
+
+private:
+    VmaAllocator allocator = nullptr;
+
+    mutable std::mutex mutex;
+    std::unordered_map<VmaAllocation, Entry> entries;
+    std::array<WCategoryStats, ALLOCATION_CATEGORY_COUNT> categories {};
+
+    void untrack(VmaAllocation allocation);
+};
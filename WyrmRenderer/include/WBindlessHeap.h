@@ -0,0 +1,63 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include "WVulkan.h"
+
+using WBindlessIndex = uint32_t;
+constexpr WBindlessIndex INVALID_BINDLESS_INDEX = ~0u;
+
+/** One update after bind descriptor set holding every storage buffer, sampled image and sampler the shaders can reach.
+    Resources are written once when they're registered and keep their index until they're freed, so the set is bound
+    once per command buffer and never touched per draw. Has to match bindless.slang **/
+class WBindlessHeap
+{
+public:
+    static constexpr uint32_t STORAGE_BUFFER_BINDING = 0;
+    static constexpr uint32_t SAMPLED_IMAGE_BINDING = 1;
+    static constexpr uint32_t SAMPLER_BINDING = 2;
+
+    static constexpr uint32_t DEFAULT_BUFFER_CAPACITY = 16 * 1024;
+    static constexpr uint32_t DEFAULT_IMAGE_CAPACITY = 16 * 1024;
+    static constexpr uint32_t DEFAULT_SAMPLER_CAPACITY = 256;
+
+    /** The capacities are clamped to what the device allows for update after bind sets **/
+    void Init(const vk::raii::Device& _device, const vk::raii::PhysicalDevice& physicalDevice,
+              uint32_t bufferCapacity = DEFAULT_BUFFER_CAPACITY, uint32_t imageCapacity = DEFAULT_IMAGE_CAPACITY, uint32_t samplerCapacity = DEFAULT_SAMPLER_CAPACITY);
+    void Destroy();
+
+    /** Throw if the array is full **/
+    [[nodiscard]] WBindlessIndex RegisterBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+    [[nodiscard]] WBindlessIndex RegisterImage(vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    [[nodiscard]] WBindlessIndex RegisterSampler(vk::Sampler sampler);
+
+    /** The index is handed out again right away, the caller has to make sure the gpu no longer uses it **/
+    void FreeBuffer(WBindlessIndex index);
+    void FreeImage(WBindlessIndex index);
+    void FreeSampler(WBindlessIndex index);
+
+    [[nodiscard]] vk::DescriptorSetLayout GetLayout() const;
+    [[nodiscard]] vk::DescriptorSet GetSet() const;
+
+private:
+    /** Hands out the indices of one binding, freed ones are reused first so the arrays stay dense **/
+    struct IndexList
+    {
+        uint32_t capacity = 0;
+        uint32_t next = 0;
+        std::vector<uint32_t> free;
+
+        [[nodiscard]] uint32_t Allocate(const char* kind);
+        void Free(uint32_t index);
+    };
+
+    const vk::raii::Device* device = nullptr;
+    vk::raii::DescriptorSetLayout layout = nullptr;
+    vk::raii::DescriptorPool pool = nullptr;
+    vk::raii::DescriptorSet set = nullptr;
+
+    IndexList buffers;
+    IndexList images;
+    IndexList samplers;
+};
@@ -0,0 +1,41 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+/** Defers the destruction of gpu resources until the frame timeline has passed the value they were last used in.
+    Entries are kept in push order, so one pushed with a lower value than its predecessor waits for that one as well.
+    Not thread safe, everything has to be called from the thread that drives the renderer. **/
+class WDeletionQueue
+{
+public:
+    void Push(uint64_t timelineValue, std::function<void()> deleter);
+
+    /** Keeps a vulkan raii object, or anything else that cleans up after itself, alive until the value is reached **/
+    template<typename T>
+    void Release(const uint64_t timelineValue, T&& object)
+    {
+        auto held = std::make_shared<std::decay_t<T>>(std::forward<T>(object));
+        Push(timelineValue, [held]() mutable { held.reset(); });
+    }
+
+    /** Runs the deleters of every entry up to completedValue **/
+    void Collect(uint64_t completedValue);
+    /** Runs every deleter regardless of its value, the device has to be idle **/
+    void Flush();
+
+    [[nodiscard]] size_t GetPendingCount() const;
+
+private:
+    struct PendingDeletion
+    {
+        uint64_t timeline_value;
+        std::function<void()> deleter;
+    };
+
+    std::deque<PendingDeletion> pending;
+};
@@ -0,0 +1,61 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <cstring>
+
+#include "WAllocationTracker.h"
+#include "WVulkan.h"
+
+/** Part of the frame buffer handed out by WFrameAllocator, offset is relative to the buffer so it can be used as a dynamic offset **/
+struct WFrameSlice
+{
+    vk::Buffer buffer = nullptr;
+    uint32_t offset = 0;
+    void* mapped = nullptr;
+    /** Only set if the buffer was created with device address usage **/
+    vk::DeviceAddress address = 0;
+};
+
+/** Linear allocator over one persistently mapped buffer split into a region per frame in flight.
+    A region is reset as a whole by BeginFrame, so it must only be called once that frame slot's timeline value has been reached. **/
+class WFrameAllocator
+{
+public:
+    static constexpr vk::DeviceSize DEFAULT_FRAME_SIZE = 16ull * 1024 * 1024;
+
+    void Init(VmaAllocator _allocator, WAllocationTracker& _tracker, const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, vk::BufferUsageFlags usage, uint32_t framesInFlight, vk::DeviceSize frameSize = DEFAULT_FRAME_SIZE);
+    void Destroy();
+
+    void BeginFrame(uint32_t frameIndex);
+    /** Makes the writes of the current frame visible to the device, a no-op on coherent memory **/
+    void Flush() const;
+
+    /** Throws if the frame region has no room left **/
+    [[nodiscard]] WFrameSlice Allocate(vk::DeviceSize size);
+
+    template<typename T>
+    WFrameSlice Push(const T& data)
+    {
+        const WFrameSlice slice = Allocate(sizeof(T));
+        memcpy(slice.mapped, &data, sizeof(T));
+        return slice;
+    }
+
+    [[nodiscard]] vk::Buffer GetBuffer() const;
+    [[nodiscard]] vk::DeviceSize GetUsedBytes() const;
+
+private:
+    VmaAllocator allocator = nullptr;
+    WAllocationTracker* tracker = nullptr;
+    vk::Buffer buffer = nullptr;
+    VmaAllocation allocation = nullptr;
+    std::byte* mapped = nullptr;
+    vk::DeviceAddress device_address = 0;
+
+    vk::DeviceSize alignment = 1;
+    vk::DeviceSize frame_size = 0;
+    vk::DeviceSize frame_begin = 0;
+    vk::DeviceSize frame_offset = 0;
+};
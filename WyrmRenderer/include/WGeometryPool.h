@@ -0,0 +1,63 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include "WAllocationTracker.h"
+#include "WVulkan.h"
+
+/** Range of a mesh inside the pool, offsets and counts are in vertices and 32 bit index slots, not bytes **/
+struct WGeometryRange
+{
+    VmaVirtualAllocation vertex_alloc = nullptr;
+    VmaVirtualAllocation index_alloc = nullptr;
+    uint32_t vertex_offset = 0;
+    uint32_t vertex_count = 0;
+    uint32_t first_index = 0;
+    uint32_t index_count = 0;
+};
+
+/** One device local vertex buffer and one index buffer shared by every mesh, ranges are carved out with VMA virtual blocks.
+    Geometry is bound once per frame and meshes are drawn by offset, which is what indirect draws need. **/
+class WGeometryPool
+{
+public:
+    static constexpr uint32_t DEFAULT_VERTEX_CAPACITY = 4 * 1024 * 1024;
+    static constexpr uint32_t DEFAULT_INDEX_CAPACITY = 16 * 1024 * 1024;
+
+    void Init(VmaAllocator _allocator, WAllocationTracker& _tracker, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity, const std::vector<uint32_t>& queueFamilies);
+    void Destroy();
+
+    /** Throws if either buffer has no free range big enough left **/
+    [[nodiscard]] WGeometryRange Allocate(uint32_t vertexCount, uint32_t indexCount);
+    /** The caller has to make sure the gpu no longer reads the range **/
+    void Free(WGeometryRange& range);
+
+    void CmdBind(const vk::raii::CommandBuffer& commandBuffer) const;
+    /** The index buffer is bound from offset 0 either way, a 16 bit first index is twice the slot **/
+    void CmdBindIndexBuffer(const vk::raii::CommandBuffer& commandBuffer, vk::IndexType indexType) const;
+
+    [[nodiscard]] vk::Buffer GetVertexBuffer() const;
+    [[nodiscard]] vk::Buffer GetIndexBuffer() const;
+    [[nodiscard]] vk::DeviceSize GetVertexByteOffset(const WGeometryRange& range) const;
+    [[nodiscard]] static vk::DeviceSize GetIndexByteOffset(const WGeometryRange& range);
+    [[nodiscard]] uint32_t GetUsedVertexCount() const;
+    [[nodiscard]] uint32_t GetUsedIndexCount() const;
+
+private:
+    VmaAllocator allocator = nullptr;
+    WAllocationTracker* tracker = nullptr;
+    uint32_t vertex_stride = 0;
+
+    vk::Buffer vertex_buffer = nullptr;
+    VmaAllocation vertex_buffer_alloc = nullptr;
+    VmaVirtualBlock vertex_block = nullptr;
+    uint32_t used_vertices = 0;
+
+    vk::Buffer index_buffer = nullptr;
+    VmaAllocation index_buffer_alloc = nullptr;
+    VmaVirtualBlock index_block = nullptr;
+    uint32_t used_indices = 0;
+
+    void create_buffer(vk::DeviceSize size, vk::BufferUsageFlags usage, const std::vector<uint32_t>& queueFamilies, std::string_view name, vk::Buffer& buffer, VmaAllocation& allocation) const;
+};
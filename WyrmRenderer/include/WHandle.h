@@ -0,0 +1,147 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/** 32 bit handle into a WHandlePool, the low bits are the slot and the high bits the generation of the slot.
+    A slot's generation changes whenever it's freed, so a stale handle no longer matches and is caught on use.
+    The zero value is never handed out and works as a null handle. **/
+template<typename Tag>
+struct WHandle
+{
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = ~0u >> INDEX_BITS;
+
+    uint32_t value = 0;
+
+    [[nodiscard]] uint32_t GetIndex() const { return value & INDEX_MASK; }
+    [[nodiscard]] uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const WHandle&) const = default;
+
+    static WHandle Make(const uint32_t index, const uint32_t generation)
+    {
+        return {generation << INDEX_BITS | index};
+    }
+};
+
+using WBufferHandle = WHandle<struct WBufferTag>;
+using WImageHandle = WHandle<struct WImageTag>;
+using WPipelineHandle = WHandle<struct WPipelineTag>;
+using WMeshHandle = WHandle<struct WMeshTag>;
+using WMaterialHandle = WHandle<struct WMaterialTag>;
+using WTextureHandle = WHandle<struct WTextureTag>;
+
+/** Slot allocator that keeps the data of every slot in one array per column instead of one struct per slot.
+    Loops that only need one column walk a dense array, freed slots are reused first so the arrays stay packed.
+    Freeing resets the slot's columns to their default, so columns hold plain vulkan handles and destruction stays with the owner. **/
+template<typename Handle, typename... Columns>
+class WHandlePool
+{
+public:
+    Handle Allocate(Columns... values)
+    {
+        uint32_t index;
+        if (!free_indices.empty())
+        {
+            index = free_indices.back();
+            free_indices.pop_back();
+            assign(index, std::index_sequence_for<Columns...> {}, std::move(values)...);
+            occupied[index] = true;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(generations.size());
+            if (index > Handle::INDEX_MASK) return {};
+
+            generations.push_back(1);
+            occupied.push_back(true);
+            append(std::index_sequence_for<Columns...> {}, std::move(values)...);
+        }
+        live_count++;
+        return Handle::Make(index, generations[index]);
+    }
+
+    /** Returns false for stale or null handles instead of freeing anything **/
+    bool Free(const Handle handle)
+    {
+        if (!IsValid(handle)) return false;
+
+        const uint32_t index = handle.GetIndex();
+        // generation 0 is skipped so no live handle can ever be null
+        generations[index] = (generations[index] + 1) & Handle::GENERATION_MASK;
+        if (generations[index] == 0)
+            generations[index] = 1;
+
+        assign(index, std::index_sequence_for<Columns...> {}, Columns {}...);
+        free_indices.push_back(index);
+        occupied[index] = false;
+        live_count--;
+        return true;
+    }
+
+    [[nodiscard]] bool IsValid(const Handle handle) const
+    {
+        const uint32_t index = handle.GetIndex();
+        return handle && index < generations.size() && generations[index] == handle.GetGeneration();
+    }
+
+    /** Unchecked, for loops that already validated their handles, e.g. draw lists holding slot indices **/
+    template<size_t Column>
+    [[nodiscard]] auto& GetColumn() { return std::get<Column>(columns); }
+    template<size_t Column>
+    [[nodiscard]] const auto& GetColumn() const { return std::get<Column>(columns); }
+
+    /** Unchecked as well, call IsValid first **/
+    template<size_t Column>
+    [[nodiscard]] auto& Get(const Handle handle) { return std::get<Column>(columns)[handle.GetIndex()]; }
+    template<size_t Column>
+    [[nodiscard]] const auto& Get(const Handle handle) const { return std::get<Column>(columns)[handle.GetIndex()]; }
+
+    /** Every live handle in slot order, e.g. to clean up whatever is left at shutdown **/
+    template<typename Function>
+    void ForEach(Function&& function) const
+    {
+        for (uint32_t index = 0; index < generations.size(); index++)
+            if (occupied[index])
+                function(Handle::Make(index, generations[index]));
+    }
+
+    [[nodiscard]] uint32_t GetCount() const { return live_count; }
+
+    void Clear()
+    {
+        generations.clear();
+        occupied.clear();
+        free_indices.clear();
+        std::apply([](auto&... column) { (column.clear(), ...); }, columns);
+        live_count = 0;
+    }
+
+private:
+    std::vector<uint32_t> generations;
+    std::vector<bool> occupied;
+    std::vector<uint32_t> free_indices;
+    std::tuple<std::vector<Columns>...> columns;
+    uint32_t live_count = 0;
+
+    template<size_t... I>
+    void assign(const uint32_t index, std::index_sequence<I...>, Columns&&... values)
+    {
+        ((std::get<I>(columns)[index] = std::move(values)), ...);
+    }
+
+    template<size_t... I>
+    void append(std::index_sequence<I...>, Columns&&... values)
+    {
+        (std::get<I>(columns).push_back(std::move(values)), ...);
+    }
+};
@@ -0,0 +1,40 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "WMappedFile.h"
+#include "WVulkan.h"
+
+/** A KTX2 file mapped into memory. libktx checks the header and describes the format, the level data is read straight
+    from the mapping, so nothing is paged in before it's uploaded. Only single layer 2D textures without supercompression
+    are supported, their levels are in a format the gpu samples as is (BC, ASTC or plain) and go up without decoding **/
+class WKtxTexture
+{
+public:
+    WKtxTexture() = default;
+    WKtxTexture(const WKtxTexture&) = delete;
+    WKtxTexture& operator=(const WKtxTexture&) = delete;
+
+    /** Throws on files libktx rejects and on anything that would have to be decoded or transcoded first **/
+    void Open(const std::filesystem::path& path);
+    void Close();
+
+    [[nodiscard]] vk::Format GetFormat() const;
+    [[nodiscard]] vk::Extent2D GetExtent(uint32_t level = 0) const;
+    [[nodiscard]] uint32_t GetLevelCount() const;
+    /** Tightly packed data of one level, level 0 is the biggest **/
+    [[nodiscard]] std::span<const std::byte> GetLevel(uint32_t level) const;
+    /** Bytes of the levels from baseLevel down to the smallest, roughly what an image holding them takes up **/
+    [[nodiscard]] vk::DeviceSize GetChainSize(uint32_t baseLevel) const;
+
+private:
+    WMappedFile file;
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent2D extent;
+    std::vector<std::span<const std::byte>> levels;
+};
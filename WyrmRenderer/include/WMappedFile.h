@@ -0,0 +1,32 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+/** Read only memory mapping of a whole file, the pages are only read in once they're touched **/
+class WMappedFile
+{
+public:
+    WMappedFile() = default;
+    WMappedFile(const WMappedFile&) = delete;
+    WMappedFile& operator=(const WMappedFile&) = delete;
+    ~WMappedFile();
+
+    /** Throws if the file can't be opened or mapped **/
+    void Open(const std::filesystem::path& path);
+    void Close();
+
+    [[nodiscard]] std::span<const std::byte> GetData() const;
+
+private:
+    const std::byte* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
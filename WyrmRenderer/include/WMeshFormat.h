@@ -0,0 +1,48 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <cstdint>
+
+#include "WVertex.h"
+
+/** Cooked mesh file, written by WyrmCooker and mapped as is by WRenderer::LoadMesh.
+    The header comes first, then the part table and the vertex and index blobs of every part, each at a WMESH_ALIGNMENT aligned offset
+    from the start of the file, so the mapped blobs can be read in place. Indices are 16 bit and local to their part. Everything is little endian. **/
+static constexpr uint32_t WMESH_MAGIC = 0x48534d57; // "WMSH"
+static constexpr uint32_t WMESH_VERSION = 2;
+static constexpr uint64_t WMESH_ALIGNMENT = 16;
+
+struct WMeshFileHeader
+{
+    uint32_t magic = WMESH_MAGIC;
+    uint32_t version = WMESH_VERSION;
+    /** sizeof(Vertex) at cook time, files with another layout are rejected **/
+    uint32_t vertex_stride = sizeof(Vertex);
+    uint32_t part_count = 0;
+    /** Byte offset of the WMeshFilePart table from the start of the file **/
+    uint64_t parts_offset = 0;
+    /** Bounds of the whole mesh, every part carries its own sphere for culling **/
+    glm::vec3 bounds_min {0.f};
+    glm::vec3 bounds_max {0.f};
+    glm::vec4 bounding_sphere {0.f};
+};
+static_assert(sizeof(WMeshFileHeader) == 64, "the header is written to disk as is");
+
+struct WMeshFilePart
+{
+    uint32_t vertex_count = 0;
+    uint32_t index_count = 0;
+    /** Byte offsets from the start of the file **/
+    uint64_t vertex_offset = 0;
+    uint64_t index_offset = 0;
+    /** Center of the part's bounds and the distance to its farthest vertex, what the cull pass tests **/
+    glm::vec4 bounding_sphere {0.f};
+};
+static_assert(sizeof(WMeshFilePart) == 40, "the part table is written to disk as is");
+
+constexpr uint64_t alignMeshOffset(const uint64_t offset)
+{
+    return (offset + WMESH_ALIGNMENT - 1) & ~(WMESH_ALIGNMENT - 1);
+}
@@ -0,0 +1,40 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "WVertex.h"
+
+/** Largest part an imported mesh is split into, every index of a part fits in 16 bits **/
+static constexpr uint32_t WMESH_MAX_PART_VERTICES = 65536;
+
+/** A piece of an imported mesh, the vertices are in the order the indices first reach them **/
+struct WMeshPart
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint16_t> indices;
+    glm::vec4 bounding_sphere {0.f};
+};
+
+struct WImportedMesh
+{
+    std::vector<WMeshPart> parts;
+    /** Vertices before deduplication, what a naive import would have uploaded **/
+    uint32_t source_vertex_count = 0;
+};
+
+/** Flattens every triangle primitive of the glTF's default scene into one mesh and runs it through optimizeMesh.
+    Node transforms are baked into the positions, missing colors default to white and missing uvs to zero.
+    Throws on files tinygltf can't read or that have no triangles **/
+[[nodiscard]] WImportedMesh importGltf(const std::filesystem::path& path);
+
+/** Merges identical vertices, orders the triangles for the post transform cache and for overdraw (Tipsify, Sander et al. 2007),
+    then splits the result into parts of at most WMESH_MAX_PART_VERTICES with their vertices in fetch order **/
+[[nodiscard]] WImportedMesh optimizeMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+/** Sphere around the center of the bounding box reaching the farthest vertex, what the cull pass tests **/
+[[nodiscard]] glm::vec4 computeBoundingSphere(std::span<const Vertex> vertices);
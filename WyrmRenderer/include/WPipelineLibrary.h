@@ -0,0 +1,137 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "WVulkan.h"
+
+/** Index of a shader added to a WPipelineLibrary **/
+using WShaderId = uint32_t;
+
+/** Single interleaved vertex binding, stored by value so it can be compared and hashed with the rest of the state **/
+struct WVertexLayout
+{
+    static constexpr uint32_t MAX_ATTRIBUTES = 8;
+
+    uint32_t stride = 0;
+    uint32_t attribute_count = 0;
+    std::array<vk::VertexInputAttributeDescription, MAX_ATTRIBUTES> attributes {};
+
+    bool operator==(const WVertexLayout&) const = default;
+};
+
+/** Everything that goes into a graphics pipeline, two equal states always build the same pipeline.
+    The viewport and scissor are dynamic and not part of it. **/
+struct WGraphicsPipelineState
+{
+    WShaderId shader = 0;
+    WVertexLayout vertex_layout;
+
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+    vk::PolygonMode polygon_mode = vk::PolygonMode::eFill;
+    vk::CullModeFlags cull_mode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace front_face = vk::FrontFace::eClockwise;
+
+    bool blend_enable = false;
+    vk::BlendFactor src_blend_factor = vk::BlendFactor::eSrcAlpha;
+    vk::BlendFactor dst_blend_factor = vk::BlendFactor::eOneMinusSrcAlpha;
+
+    bool depth_test = false;
+    bool depth_write = false;
+    vk::CompareOp depth_compare = vk::CompareOp::eLessOrEqual;
+
+    vk::Format color_format = vk::Format::eUndefined;
+    /** eUndefined renders without a depth attachment **/
+    vk::Format depth_format = vk::Format::eUndefined;
+
+    bool operator==(const WGraphicsPipelineState&) const = default;
+    [[nodiscard]] size_t Hash() const;
+};
+
+/** Cache of graphics pipelines keyed by their full state. Missing pipelines are built on a few worker threads,
+    so asking for a new state never waits on the driver compiler, Find just returns null until it's done.
+    Not thread safe, everything but the workers themselves runs on the render thread. **/
+class WPipelineLibrary
+{
+public:
+    WPipelineLibrary() = default;
+    WPipelineLibrary(const WPipelineLibrary&) = delete;
+    WPipelineLibrary& operator=(const WPipelineLibrary&) = delete;
+    ~WPipelineLibrary();
+
+    /** The device, cache and layout have to outlive the library, every pipeline uses the same layout **/
+    void Init(const vk::raii::Device& _device, const vk::raii::PipelineCache& _pipelineCache, vk::PipelineLayout _layout, uint32_t workerCount);
+    /** Waits for the compiles in progress, the pipelines are destroyed right away so the device has to be idle **/
+    void Destroy();
+
+    /** The module holds both stages, the code is copied into a shader module right away **/
+    [[nodiscard]] WShaderId AddShader(std::span<const uint32_t> spirv, std::string vertexEntry, std::string fragmentEntry);
+    /** Swaps the code of a shader and drops every pipeline that was built from the old one.
+        The dropped pipelines are returned, since frames in flight may still use them **/
+    [[nodiscard]] std::vector<vk::raii::Pipeline> ReplaceShader(WShaderId shader, std::span<const uint32_t> spirv);
+
+    /** Builds the pipeline on the calling thread without caching it **/
+    [[nodiscard]] vk::raii::Pipeline Build(const WGraphicsPipelineState& state) const;
+    /** Null while the pipeline is still compiling, the first call for a state queues it for the workers.
+        A state that failed to compile stays null for good, the error is printed once **/
+    [[nodiscard]] vk::Pipeline Find(const WGraphicsPipelineState& state);
+    /** Moves what the workers finished into the cache, returns true if anything new became ready **/
+    bool CollectFinished();
+
+    [[nodiscard]] uint32_t GetPendingCount() const;
+
+private:
+    struct StateHash
+    {
+        size_t operator()(const WGraphicsPipelineState& state) const { return state.Hash(); }
+    };
+
+    /** Jobs hold on to the module, so a replaced shader can't disappear under a compile **/
+    struct Shader
+    {
+        std::shared_ptr<const vk::raii::ShaderModule> module;
+        std::string vertex_entry;
+        std::string fragment_entry;
+        uint32_t generation = 0;
+    };
+
+    struct CompileResult
+    {
+        WGraphicsPipelineState state;
+        uint32_t generation = 0;
+        /** Null if the driver rejected the state **/
+        vk::raii::Pipeline pipeline = nullptr;
+    };
+
+    const vk::raii::Device* device = nullptr;
+    const vk::raii::PipelineCache* pipeline_cache = nullptr;
+    vk::PipelineLayout layout = nullptr;
+
+    std::vector<Shader> shaders;
+    std::unordered_map<WGraphicsPipelineState, vk::raii::Pipeline, StateHash> pipelines;
+    std::unordered_set<WGraphicsPipelineState, StateHash> pending;
+    // rejected by the driver, never queued again
+    std::unordered_set<WGraphicsPipelineState, StateHash> failed;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::deque<std::pair<WGraphicsPipelineState, Shader>> jobs;
+    std::vector<CompileResult> finished;
+
+    void worker_loop();
+    [[nodiscard]] vk::raii::Pipeline build(const WGraphicsPipelineState& state, const Shader& shader) const;
+};
@@ -0,0 +1,137 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "WVulkan.h"
+
+struct WZoneTiming
+{
+    const char* name = nullptr;
+    float milliseconds = 0.f;
+};
+
+struct WFrameTimings
+{
+    static constexpr uint32_t MAX_CPU_ZONES = 16;
+    static constexpr uint32_t MAX_GPU_SCOPES = 16;
+
+    uint64_t frame_number = 0;
+    float cpu_frame_ms = 0.f;
+    float gpu_frame_ms = 0.f;
+
+    uint32_t cpu_zone_count = 0;
+    uint32_t gpu_scope_count = 0;
+    std::array<WZoneTiming, MAX_CPU_ZONES> cpu_zones {};
+    std::array<WZoneTiming, MAX_GPU_SCOPES> gpu_scopes {};
+};
+
+struct WTimingSummary
+{
+    uint32_t sample_count = 0;
+    float min_ms = 0.f;
+    float avg_ms = 0.f;
+    float p99_ms = 0.f;
+    float max_ms = 0.f;
+};
+
+/** Collects CPU zone and GPU timestamp timings per frame without allocating or stalling.
+    Everything except the Get/Summarize functions has to be called from the thread that records the frames,
+    the readers only touch the published ring and can run on any thread. **/
+class WProfiler
+{
+public:
+    static constexpr uint32_t RING_SIZE = 256;
+
+    void Init(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, uint32_t queueFamilyIndex, uint32_t framesInFlight);
+    void Destroy();
+
+    void SetEnabled(bool _enabled);
+    [[nodiscard]] bool IsEnabled() const;
+
+    void BeginFrame(uint32_t frameIndex);
+    /** Reads back the timestamps of the last frame that used this slot, call once the slot's timeline value has been reached **/
+    void ResolveFrame(uint32_t frameIndex);
+    void EndFrame();
+
+    [[nodiscard]] uint32_t BeginCpuZone(const char* name);
+    void EndCpuZone(uint32_t zone);
+
+    /** Has to be recorded outside of any rendering scope before the first CmdBeginScope of the frame **/
+    void CmdResetQueries(const vk::raii::CommandBuffer& commandBuffer);
+    void CmdBeginScope(const vk::raii::CommandBuffer& commandBuffer, const char* name);
+    void CmdEndScope(const vk::raii::CommandBuffer& commandBuffer);
+
+    /** Number the next BeginFrame will assign, frames are published in this order once their gpu half is known **/
+    [[nodiscard]] uint64_t GetNextFrameNumber() const;
+    [[nodiscard]] uint64_t GetPublishedFrameCount() const;
+    /** Fails if the frame is not published yet, has already been overwritten in the ring or is being overwritten **/
+    bool GetFrame(uint64_t frameNumber, WFrameTimings& timings) const;
+    bool GetLatestFrame(WFrameTimings& timings) const;
+    [[nodiscard]] WTimingSummary SummarizeCpuFrame(uint32_t window = 120) const;
+    [[nodiscard]] WTimingSummary SummarizeGpuFrame(uint32_t window = 120) const;
+    [[nodiscard]] WTimingSummary SummarizeCpuZone(const char* name, uint32_t window = 120) const;
+    [[nodiscard]] WTimingSummary SummarizeGpuScope(const char* name, uint32_t window = 120) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct FrameQueries
+    {
+        vk::raii::QueryPool pool = nullptr;
+        uint32_t query_count = 0;
+        std::array<const char*, WFrameTimings::MAX_GPU_SCOPES> scope_names {};
+        WFrameTimings pending {};
+        bool has_pending = false;
+    };
+
+    struct RingSlot
+    {
+        std::atomic<uint64_t> sequence = 0;
+        WFrameTimings timings {};
+    };
+
+    bool enabled = true;
+    bool gpu_timing_supported = false;
+    float timestamp_period = 0.f;
+    uint64_t timestamp_mask = ~0ull;
+    VkDevice device = VK_NULL_HANDLE;
+
+    std::vector<FrameQueries> frame_queries;
+    uint32_t current_slot = 0;
+    uint64_t frame_number = 0;
+
+    WFrameTimings current {};
+    Clock::time_point frame_start {};
+    std::array<Clock::time_point, WFrameTimings::MAX_CPU_ZONES> zone_starts {};
+
+    std::array<uint32_t, WFrameTimings::MAX_GPU_SCOPES> open_scopes {};
+    uint32_t open_scope_count = 0;
+
+    std::array<RingSlot, RING_SIZE> ring {};
+    std::atomic<uint64_t> published = 0;
+
+    void publish(const WFrameTimings& timings);
+
+    template<typename Sample>
+    WTimingSummary summarize(uint32_t window, Sample sample) const;
+};
+
+/** Times the enclosing scope as a named CPU zone of the current frame **/
+class WCpuZone
+{
+public:
+    WCpuZone(WProfiler& _profiler, const char* name);
+    ~WCpuZone();
+
+    WCpuZone(const WCpuZone&) = delete;
+    WCpuZone& operator=(const WCpuZone&) = delete;
+
+private:
+    WProfiler& profiler;
+    uint32_t zone;
+};
@@ -6,9 +6,29 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
-#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
-#include <vulkan/vulkan_raii.hpp>
 #include <glm/glm.hpp>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include "WVulkan.h"
+#include "WVertex.h"
+#include "WProfiler.h"
+#include "WUploadManager.h"
+#include "WGeometryPool.h"
+#include "WFrameAllocator.h"
+#include "WWorkerPool.h"
+#include "WDeletionQueue.h"
+#include "WBindlessHeap.h"
+#include "WHandle.h"
+#include "WShaderHotReload.h"
+#include "WPipelineLibrary.h"
+#include "WKtxTexture.h"
+#include "WResidencyManager.h"
+#include "WAllocationTracker.h"
 
 #ifdef NDEBUG
 static constexpr bool enableValidationLayers = false;
@@ -19,11 +39,56 @@ const std::vector<const char*> validationLayers = {
 };
 #endif
 
-struct VmaAllocator_T;
-using VmaAllocator = VmaAllocator_T*;
+struct UniformBufferObject
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+};
+
+/** Per instance data of DrawInstanced, has to match InstanceData in scene.slang **/
+struct InstanceData
+{
+    glm::mat4 transform;
+    /** Multiplied with the vertex color **/
+    glm::vec4 color {1.f};
+};
+
+/** Per draw record read by the cull pass and the vertex shader, has to match GpuObject in scene.slang **/
+struct GpuObject
+{
+    glm::mat4 model;
+    glm::vec4 bounding_sphere;
+    uint32_t index_count;
+    uint32_t first_index;
+    int32_t vertex_offset;
+    uint32_t instance_count;
+    /** Points at instance_count InstanceData, 0 for plain draws **/
+    vk::DeviceAddress instances;
+    /** Draws sharing a pipeline form a batch, the cull pass compacts each batch into its own range starting at batch_first **/
+    uint32_t batch;
+    uint32_t batch_first;
+    /** Bindless indices, INVALID_BINDLESS_INDEX for untextured draws **/
+    uint32_t texture;
+    uint32_t sampler;
+    /** The shader rounds the struct up to the alignment of its matrix **/
+    uint32_t padding[2];
+};
+static_assert(sizeof(GpuObject) % 16 == 0, "has to match the stride of the objects buffer");
 
-struct VmaAllocation_T;
-using VmaAllocation = VmaAllocation_T*;
+struct CullConstants
+{
+    std::array<glm::vec4, 6> frustum_planes;
+    uint32_t object_count;
+};
+
+/** What a draw does while its material's pipeline is still compiling **/
+enum WPendingPipelinePolicy : uint8_t
+{
+    /** Draws with the default pipeline **/
+    PENDING_PIPELINE_FALLBACK,
+    /** Leaves the draw out until the pipeline is ready **/
+    PENDING_PIPELINE_SKIP
+};
 
 class WRenderer
 {
@@ -35,11 +100,141 @@ public:
 
     static WRenderer& GetInstance();
     [[nodiscard]] GLFWwindow* GetWindow() const;
+    [[nodiscard]] WProfiler& GetProfiler();
     void SetWindowSize(int _width, int _height);
-
+    void SetHeadless(bool _headless);
+    [[nodiscard]] bool IsHeadless() const;
+    /** Where the pipeline cache is loaded from and saved to, defaults to a WyrmEngine folder in the temp directory **/
+    void SetPipelineCachePath(const std::filesystem::path& path);
+    /** Size of the shared mesh buffers in vertices and indices, has to be set before InitVulkan **/
+    void SetGeometryPoolCapacity(uint32_t vertexCount, uint32_t indexCount);
+    /** Culls and compacts the draws in a compute pass and renders them with one indirect draw, otherwise every draw is recorded on the cpu **/
+    void SetGpuCulling(bool enabled);
+    [[nodiscard]] bool IsGpuCulling() const;
+    /** Number of threads cpu draws are recorded on, has to be set before InitVulkan. Defaults to the core count capped at 8 **/
+    void SetRecordThreadCount(uint32_t count);
+    /** Replaces the renderer's own worker threads, e.g. with an engine job system. Reset with an empty function **/
+    void SetParallelFor(WParallelFor parallelFor);
+    /** How many frames the cpu may run ahead of the gpu, 1 to MAX_FRAMES_IN_FLIGHT. Has to be set before InitVulkan, defaults to 2 **/
+    void SetFramesInFlight(uint32_t count);
+    [[nodiscard]] uint32_t GetFramesInFlight() const;
+    void SetPendingPipelinePolicy(WPendingPipelinePolicy policy);
+    /** Bytes of streamed mip data handed to the upload queue per frame, a level bigger than the budget still goes out on its own **/
+    void SetTextureStreamBudget(vk::DeviceSize bytesPerFrame);
+    /** Device local memory the renderer keeps itself under by shrinking the least recently used textures, 0 uses the driver budget.
+        Can be changed at any time, the textures adjust over the next frames **/
+    void SetMemoryCeiling(vk::DeviceSize bytes);
+    /** As of the last frame, across the device local heaps **/
+    [[nodiscard]] vk::DeviceSize GetMemoryUsage() const;
+    [[nodiscard]] vk::DeviceSize GetMemoryBudget() const;
+    /** Walks every allocation, meant for debug overlays and reports rather than every frame **/
+    [[nodiscard]] WMemoryStats GetMemoryStats() const;
+    /** JSON with VMA's statistics and the tracked bytes per category, detailed lists every allocation by name **/
+    [[nodiscard]] std::string BuildMemoryReport(bool detailed = false) const;
+    void WriteMemoryReport(const std::filesystem::path& path, bool detailed = true) const;
+    /** Cleanup writes a detailed report there, including the buffers, images and textures that were never destroyed **/
+    void SetMemoryReportPath(const std::filesystem::path& path);
+
+    [[nodiscard]] std::string GetDeviceName() const;
+
+    /** DrawFrame may run on another thread afterwards, but glfw itself stays on the thread that created the window **/
     void InitWindow();
     void InitVulkan();
     void Cleanup();
+    /** Also runs the deferred deletions, since nothing they hold is in use once the device is idle **/
+    void WaitIdle();
+
+    /** Submits the uploads queued so far instead of waiting for the next DrawFrame, returns the value to wait on **/
+    uint64_t FlushUploads();
+    void WaitForUploads(uint64_t value) const;
+
+    /** Every frame signals the graphics timeline with the next value, so gpu progress is a single increasing number **/
+    [[nodiscard]] vk::Semaphore GetFrameTimelineSemaphore() const;
+    /** Value the most recently submitted frame signals once it's done, 0 before the first submit **/
+    [[nodiscard]] uint64_t GetSubmittedFrameValue() const;
+    [[nodiscard]] uint64_t GetCompletedFrameValue() const;
+    void WaitForFrameValue(uint64_t value) const;
+
+    /** Destroys the object once every frame recorded so far, the one currently being built included, has finished on the gpu.
+        Meant for vulkan raii objects like pipelines, image views and descriptor sets **/
+    template<typename T>
+    void Release(T&& object)
+    {
+        deletion_queue.Release(frame_timeline_value + 1, std::forward<T>(object));
+    }
+
+    /** Host visible buffers stay mapped for their whole life, the device address is only set with device address usage.
+        The category and name show up in the memory reports **/
+    [[nodiscard]] WBufferHandle CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, bool hostVisible = false,
+                                             WAllocationCategory category = ALLOCATION_BUFFER, std::string_view debugName = {});
+    /** The handle is invalid right away, the buffer itself lives until the frames that may still use it are done **/
+    void DestroyBuffer(WBufferHandle buffer);
+    [[nodiscard]] bool IsValid(WBufferHandle buffer) const;
+    [[nodiscard]] vk::Buffer GetBuffer(WBufferHandle buffer) const;
+    [[nodiscard]] vk::DeviceAddress GetBufferAddress(WBufferHandle buffer) const;
+    [[nodiscard]] void* GetBufferMapped(WBufferHandle buffer) const;
+
+    /** Creates the image together with a view over all of its mips and layers **/
+    [[nodiscard]] WImageHandle CreateImage(const vk::ImageCreateInfo& imageCI, WAllocationCategory category = ALLOCATION_IMAGE, std::string_view debugName = {});
+    void DestroyImage(WImageHandle image);
+    [[nodiscard]] bool IsValid(WImageHandle image) const;
+    [[nodiscard]] vk::Image GetImage(WImageHandle image) const;
+    [[nodiscard]] vk::ImageView GetImageView(WImageHandle image) const;
+
+    /** Registered resources keep a fixed index into the bindless arrays of set 1 until they're unregistered **/
+    [[nodiscard]] WBindlessIndex RegisterBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+    [[nodiscard]] WBindlessIndex RegisterImage(vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    [[nodiscard]] WBindlessIndex RegisterSampler(vk::Sampler sampler);
+    /** The index is only handed out again once the frames that may still use it are done **/
+    void UnregisterBuffer(WBindlessIndex index);
+    void UnregisterImage(WBindlessIndex index);
+    void UnregisterSampler(WBindlessIndex index);
+
+    /** Queues the geometry upload without blocking, the next DrawFrame submits it and waits for it on the gpu **/
+    [[nodiscard]] WMeshHandle CreateMesh(std::span<const Vertex> meshVertices, std::span<const uint32_t> meshIndices);
+    /** Half the index memory and bandwidth, for meshes of at most 65536 vertices **/
+    [[nodiscard]] WMeshHandle CreateMesh(std::span<const Vertex> meshVertices, std::span<const uint16_t> meshIndices);
+    /** Maps a mesh cooked by WyrmCooker and copies its blobs from the mapping straight into staging, nothing is parsed or copied on the cpu.
+        Returns one mesh per part, they're meant to be drawn together **/
+    [[nodiscard]] std::vector<WMeshHandle> LoadMesh(const std::filesystem::path& path);
+    /** Imports and optimizes a glTF at runtime, see importGltf. Returns one mesh per part, they're meant to be drawn together **/
+    [[nodiscard]] std::vector<WMeshHandle> ImportGltf(const std::filesystem::path& path);
+    /** The geometry range is released once the frames that may still draw the mesh are done, the handle is invalid right away **/
+    void DestroyMesh(WMeshHandle mesh);
+    [[nodiscard]] bool IsValid(WMeshHandle mesh) const;
+
+    /** Maps a KTX2 file and uploads only its small mips right away, so the texture can be sampled from the next frame on.
+        The bigger mips stream in over the following frames within the stream budget, from the smallest up **/
+    [[nodiscard]] WTextureHandle LoadTexture(const std::filesystem::path& path);
+    /** The image is released once the frames and uploads that may still use it are done, the handle is invalid right away **/
+    void DestroyTexture(WTextureHandle texture);
+    [[nodiscard]] bool IsValid(WTextureHandle texture) const;
+    /** Changes whenever more mips become resident, look it up again every frame **/
+    [[nodiscard]] WBindlessIndex GetTextureIndex(WTextureHandle texture) const;
+    /** Finest mip that can be sampled right now, 0 once the texture is fully streamed in. Goes up again when the texture is shrunk to stay in budget **/
+    [[nodiscard]] uint32_t GetTextureResidentMip(WTextureHandle texture) const;
+    /** Linear filtering with repeat addressing, what textured materials sample with **/
+    [[nodiscard]] WBindlessIndex GetDefaultSamplerIndex() const;
+
+    /** State of the pipeline every draw without a material uses, a starting point for materials. Valid after InitVulkan **/
+    [[nodiscard]] WGraphicsPipelineState GetDefaultPipelineState() const;
+    /** The pipeline starts compiling in the background right away, draws follow the pending pipeline policy until it's done **/
+    [[nodiscard]] WMaterialHandle CreateMaterial(const WGraphicsPipelineState& state);
+    /** The pipeline stays cached in the library, so recreating the same material later is free **/
+    void DestroyMaterial(WMaterialHandle material);
+    [[nodiscard]] bool IsValid(WMaterialHandle material) const;
+    [[nodiscard]] bool IsMaterialReady(WMaterialHandle material) const;
+    /** Multiplied with the vertex colors through the default sampler, a null texture leaves them as they are **/
+    void SetMaterialTexture(WMaterialHandle material, WTextureHandle texture);
+
+    /** Queues a draw for the next DrawFrame, the queue is cleared once the frame has been recorded. Throws on a stale mesh handle.
+        A null material draws with the default pipeline **/
+    void Draw(WMeshHandle mesh, const glm::mat4& transform, WMaterialHandle material = {});
+    /** Renders every instance with a single draw, the transforms are in world space.
+        The instances are copied, so the span only has to live until the call returns **/
+    void DrawInstanced(WMeshHandle mesh, std::span<const InstanceData> instances, WMaterialHandle material = {});
+    /** The projection is used as is, so it already has to be in vulkan clip space **/
+    void SetCamera(const glm::mat4& view, const glm::mat4& projection);
 
     void DrawFrame();
 
@@ -51,6 +246,7 @@ private:
     uint32_t width = 1280;
     uint32_t height = 720;
     GLFWwindow* window = nullptr;
+    bool headless = false;
 
     vk::raii::Context context;
     vk::raii::Instance instance = nullptr;
@@ -61,42 +257,220 @@ private:
     vk::raii::Device device = nullptr;
 
     VmaAllocator allocator = nullptr;
+    WAllocationTracker allocation_tracker;
+    std::filesystem::path memory_report_path;
 
     uint32_t queue_index = ~0;
+    uint32_t transfer_queue_index = ~0;
     vk::raii::Queue graphics_queue = nullptr;
     vk::raii::Queue present_queue = nullptr;
+    std::vector<uint32_t> buffer_queue_families;
+
+    WUploadManager upload_manager;
+    WResidencyManager residency_manager;
+    bool memory_budget_supported = false;
+    static constexpr vk::PipelineStageFlags2 UPLOAD_CONSUMER_STAGES =
+        vk::PipelineStageFlagBits2::eVertexInput |
+        vk::PipelineStageFlagBits2::eDrawIndirect |
+        vk::PipelineStageFlagBits2::eVertexShader |
+        vk::PipelineStageFlagBits2::eFragmentShader |
+        vk::PipelineStageFlagBits2::eComputeShader;
 
     vk::raii::SwapchainKHR swap_chain = nullptr;
     std::vector<vk::Image> swap_chain_images;
     vk::Format swap_chain_image_format = vk::Format::eUndefined;
     vk::Extent2D swap_chain_extent;
     std::vector<vk::raii::ImageView> swap_chain_image_views;
+    std::vector<VmaAllocation> offscreen_image_allocs;
+
+    /** Swap chain that was replaced while frames using it were still in flight, handed to the deletion queue **/
+    struct WRetiredSwapChain
+    {
+        vk::raii::SwapchainKHR swap_chain = nullptr;
+        std::vector<vk::raii::ImageView> image_views;
+        std::vector<vk::raii::Semaphore> render_finished_semaphores;
+        // headless only, swap chain images are owned by the swap chain
+        std::vector<vk::Image> offscreen_images;
+        std::vector<VmaAllocation> offscreen_image_allocs;
+    };
 
     vk::raii::DescriptorSetLayout descriptor_set_layout = nullptr;
     vk::raii::PipelineLayout pipeline_layout = nullptr;
-    vk::raii::Pipeline graphics_pipeline = nullptr;
+    WPipelineHandle graphics_pipeline;
+
+    WPipelineLibrary pipeline_library;
+    WShaderId scene_shader = 0;
+    WGraphicsPipelineState default_pipeline_state;
+    WPendingPipelinePolicy pending_pipeline_policy = PENDING_PIPELINE_FALLBACK;
+    static constexpr uint32_t MAX_PIPELINE_COMPILE_THREADS = 2;
+
+    /** The pipeline column is null until the library finished compiling the state **/
+    enum WMaterialColumn : size_t { MATERIAL_STATE, MATERIAL_PIPELINE, MATERIAL_TEXTURE };
+    WHandlePool<WMaterialHandle, WGraphicsPipelineState, vk::Pipeline, WTextureHandle> material_pool;
+
+    /** Levels at most this big on either side are uploaded with the texture, they're sampled until the rest has streamed in **/
+    static constexpr uint32_t TEXTURE_PLACEHOLDER_SIZE = 64;
+    static constexpr vk::DeviceSize DEFAULT_TEXTURE_STREAM_BUDGET = 8ull * 1024 * 1024;
+    vk::DeviceSize texture_stream_budget = DEFAULT_TEXTURE_STREAM_BUDGET;
+    /** Textures drawn within this many frames may grow back to full quality once there's room again **/
+    static constexpr uint64_t TEXTURE_IDLE_FRAMES = 120;
+    /** Where streaming picks up next frame, so a texture early in the pool can't starve the others **/
+    uint32_t texture_stream_cursor = 0;
+    /** Upload value of the last batch of streamed levels, frames don't wait on it **/
+    uint64_t texture_stream_value = 0;
+    /** Highest upload value whose levels or images are sampled by now. Seeing it done on the cpu doesn't order the copies before the reads,
+        so every frame still waits on it, which costs nothing since it's already signaled **/
+    uint64_t texture_published_value = 0;
+    /** Scratch for ranking the textures by when they were last drawn **/
+    std::vector<uint32_t> residency_order;
+
+    /** Streaming and residency state of a texture. Mips are counted in the source file, the image only holds the chain from base_mip on.
+        Moving base_mip means building a new image, which is how a texture gives memory back or makes room for finer mips **/
+    struct WTextureStream
+    {
+        /** Kept mapped for as long as the texture may be shrunk and grown again, null for textures that fit the placeholder **/
+        std::unique_ptr<WKtxTexture> source;
+        vk::Format format = vk::Format::eUndefined;
+        uint32_t level_count = 0;
+        uint32_t placeholder_mip = 0;
+        uint32_t base_mip = 0;
+        /** Where the residency manager wants base_mip to be **/
+        uint32_t target_mip = 0;
+        uint32_t resident_mip = 0;
+        /** Upload timeline value that brings in the level above resident_mip, 0 while nothing is in flight **/
+        uint64_t pending_value = 0;
+        /** Frame timeline value of the last frame that drew with the texture **/
+        uint64_t last_used = 0;
+
+        /** Image starting at rebuild_base_mip whose resident levels are being uploaded, swapped in once rebuild_value is done **/
+        vk::Image rebuild_image = nullptr;
+        VmaAllocation rebuild_allocation = nullptr;
+        uint32_t rebuild_base_mip = 0;
+        uint64_t rebuild_value = 0;
+    };
+    enum WTextureColumn : size_t { TEXTURE_IMAGE, TEXTURE_ALLOCATION, TEXTURE_VIEW, TEXTURE_INDEX, TEXTURE_STREAM };
+    WHandlePool<WTextureHandle, vk::Image, VmaAllocation, vk::ImageView, WBindlessIndex, WTextureStream> texture_pool;
 
-    vk::Buffer vertex_buffer = nullptr;
-    VmaAllocation vertex_buffer_alloc = nullptr;
-    vk::Buffer index_buffer = nullptr;
-    VmaAllocation index_buffer_alloc = nullptr;
+    vk::raii::Sampler default_sampler = nullptr;
+    WBindlessIndex default_sampler_index = INVALID_BINDLESS_INDEX;
 
-    std::vector<vk::Buffer> uniform_buffers;
-    std::vector<VmaAllocation> uniform_buffer_allocs;
-    std::vector<void*> uniform_buffers_mapped;
+    bool gpu_culling = true;
+    vk::raii::DescriptorSetLayout cull_descriptor_set_layout = nullptr;
+    vk::raii::PipelineLayout cull_pipeline_layout = nullptr;
+    WPipelineHandle cull_pipeline;
+    std::vector<vk::raii::DescriptorSet> cull_descriptor_sets;
+    std::array<glm::vec4, 6> frustum_planes {};
+
+    struct WIndirectBuffers
+    {
+        WBufferHandle commands;
+        WBufferHandle count;
+        uint32_t capacity = 0;
+    };
+    std::vector<WIndirectBuffers> indirect_buffers;
+
+    std::filesystem::path pipeline_cache_path;
+    vk::raii::PipelineCache pipeline_cache = nullptr;
+
+    WGeometryPool geometry_pool;
+    uint32_t geometry_vertex_capacity = WGeometryPool::DEFAULT_VERTEX_CAPACITY;
+    uint32_t geometry_index_capacity = WGeometryPool::DEFAULT_INDEX_CAPACITY;
+
+    // resource metadata lives in one array per field, the columns are named by these indices
+    enum WBufferColumn : size_t { BUFFER_HANDLE, BUFFER_ALLOCATION, BUFFER_MAPPED, BUFFER_ADDRESS };
+    WHandlePool<WBufferHandle, vk::Buffer, VmaAllocation, void*, vk::DeviceAddress> buffer_pool;
+
+    enum WImageColumn : size_t { IMAGE_HANDLE, IMAGE_ALLOCATION, IMAGE_VIEW };
+    WHandlePool<WImageHandle, vk::Image, VmaAllocation, vk::ImageView> image_pool;
+
+    enum WPipelineColumn : size_t { PIPELINE_HANDLE, PIPELINE_BIND_POINT };
+    WHandlePool<WPipelineHandle, vk::Pipeline, vk::PipelineBindPoint> pipeline_pool;
+
+    /** The part of a mesh the draw loops read, kept apart from the allocation data they never touch **/
+    struct WMeshDraw
+    {
+        /** In units of index_type, 16 bit meshes pack two indices into every 32 bit slot of the pool **/
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+        int32_t vertex_offset = 0;
+        vk::IndexType index_type = vk::IndexType::eUint32;
+    };
+    enum WMeshColumn : size_t { MESH_DRAW, MESH_BOUNDS, MESH_GEOMETRY };
+    WHandlePool<WMeshHandle, WMeshDraw, glm::vec4, WGeometryRange> mesh_pool;
+
+    struct WDrawCommand
+    {
+        /** Slot in the mesh pool, the handle was checked when the draw was queued **/
+        uint32_t mesh_index;
+        glm::mat4 transform;
+        glm::vec4 bounding_sphere;
+        /** Range in instance_list, a count of 0 is a plain draw **/
+        uint32_t first_instance = 0;
+        uint32_t instance_count = 0;
+        WMaterialHandle material;
+        /** Resolved from the material and the mesh right before the frame is recorded **/
+        vk::Pipeline pipeline = nullptr;
+        vk::IndexType index_type = vk::IndexType::eUint32;
+    };
+    std::vector<WDrawCommand> draw_list;
+    std::vector<InstanceData> instance_list;
+
+    /** Run of draw_list sharing a pipeline and an index type, the draws are sorted by both before recording **/
+    struct WDrawBatch
+    {
+        vk::Pipeline pipeline = nullptr;
+        vk::IndexType index_type = vk::IndexType::eUint32;
+        uint32_t first_draw = 0;
+        uint32_t draw_count = 0;
+    };
+    std::vector<WDrawBatch> draw_batches;
+
+    bool custom_camera = false;
+    glm::mat4 camera_view {1.f};
+    glm::mat4 camera_projection {1.f};
+
+    WFrameAllocator frame_allocator;
+    uint32_t frame_constants_offset = 0;
+    uint32_t objects_offset = 0;
 
     vk::raii::DescriptorPool descriptor_pool = nullptr;
-    std::vector<vk::raii::DescriptorSet> descriptor_sets;
+    vk::raii::DescriptorSet descriptor_set = nullptr;
 
     vk::raii::CommandPool command_pool = nullptr;
     std::vector<vk::raii::CommandBuffer> command_buffers;
 
+    /** Command pool and secondary buffer of one recording task, one per task and frame in flight **/
+    struct WRecordSlot
+    {
+        vk::raii::CommandPool pool = nullptr;
+        vk::raii::CommandBuffer secondary = nullptr;
+    };
+    std::vector<WRecordSlot> record_slots;
+    uint32_t record_thread_count = 0;
+    WParallelFor parallel_for;
+    WWorkerPool worker_pool;
+    static constexpr uint32_t MIN_DRAWS_PER_RECORD_TASK = 256;
+
+    // acquire and present only take binary semaphores, frame pacing itself runs on the timeline
     std::vector<vk::raii::Semaphore> present_complete_semaphores;
     std::vector<vk::raii::Semaphore> render_finished_semaphores;
-    std::vector<vk::raii::Fence> in_flight_fences;
+    vk::raii::Semaphore frame_timeline = nullptr;
+    uint64_t frame_timeline_value = 0;
+    /** Timeline value the last submit of each frame slot signals, the slot is free again once it's reached **/
+    std::vector<uint64_t> frame_slot_values;
+    WDeletionQueue deletion_queue;
+
+    WBindlessHeap bindless_heap;
+
+    // indices into the programs handed to the hot reload
+    enum WShaderProgramIndex : uint32_t { SCENE_PROGRAM, CULL_PROGRAM };
+    WShaderHotReload shader_hot_reload;
 
     uint32_t frame_index = 0;
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    uint32_t frames_in_flight = 2;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    WProfiler profiler;
 
     void create_vulkan_instance();
     [[nodiscard]] std::vector<const char*> get_required_layers() const;
@@ -110,83 +484,103 @@ private:
     uint32_t get_presentation_qfp_index(uint32_t& graphicsIndex) const;
     void vma_init();
 
-    void create_swap_chain();
+    void create_swap_chain(vk::SwapchainKHR oldSwapChain = nullptr);
+    void create_offscreen_images();
     void create_image_views();
+    void create_present_semaphores();
 
     void create_descriptor_set_layout();
+    void create_pipeline_cache();
+    void save_pipeline_cache() const;
     void create_graphics_pipeline();
-    [[nodiscard]] vk::raii::ShaderModule create_shader_module(const std::vector<char>& code);
+    void create_cull_pipeline();
+    [[nodiscard]] vk::raii::Pipeline build_cull_pipeline(const vk::raii::ShaderModule& shaderModule) const;
+    void start_shader_hot_reload();
+    [[nodiscard]] vk::raii::ShaderModule create_shader_module(std::span<const uint32_t> code) const;
+    /** Swaps in the pipelines of shaders the hot reload rebuilt, the old ones are released through the deletion queue **/
+    void apply_reloaded_shaders();
 
     void create_command_pool();
     void create_command_buffers();
+    void create_record_slots();
 
-    void create_vertex_buffer();
-    void create_index_buffer();
-    void copy_buffer(const vk::Buffer& srcBuffer, const vk::Buffer& dstBuffer, vk::DeviceSize size) const;
-    void create_uniform_buffers();
 
     void create_descriptor_pool();
     void create_descriptor_sets();
+    void ensure_indirect_capacity(uint32_t drawCount);
+    void destroy_indirect_buffers(WIndirectBuffers& buffers);
 
     void create_sync_object();
 
-    void update_uniform_buffers(uint32_t currentImage) const;
+    /** Picks up pipelines the library finished since the last frame **/
+    void update_material_pipelines();
+    void create_default_sampler();
+    /** Moves the target mips of the textures so the memory usage stays between the residency manager's watermarks.
+        The least recently used textures shrink first, recently drawn ones grow back first **/
+    void update_texture_residency();
+    /** Publishes the levels and images whose uploads finished and queues the next ones within the stream budget **/
+    void stream_textures();
+    /** Image holding the source's chain from baseMip on, null if the allocation failed. withinBudget makes VMA fail rather than go over the driver budget **/
+    [[nodiscard]] std::pair<vk::Image, VmaAllocation> create_texture_image(const WKtxTexture& source, uint32_t baseMip, bool withinBudget, std::string_view name);
+    /** Starts building an image at the target mip, false if there was no memory for it **/
+    bool begin_texture_rebuild(uint32_t textureIndex);
+    void finish_texture_rebuild(uint32_t textureIndex);
+    /** Swaps the texture's view and bindless index for ones that start at its new resident mip **/
+    void update_texture_view(uint32_t textureIndex, uint32_t residentMip);
+    /** Destroys the images of a destroyed texture once the transfer queue is done with them, deferred by another frame until then **/
+    void release_texture_images(vk::Image image, VmaAllocation allocation, vk::Image rebuildImage, VmaAllocation rebuildAllocation, uint64_t uploadValue);
+    /** Resolves every draw's pipeline, applies the pending policy and sorts the draws into batches **/
+    void build_draw_batches();
+    void update_frame_constants();
+    void write_gpu_objects();
+    [[nodiscard]] WMeshHandle create_mesh(const void* vertexData, uint32_t vertexCount, const void* indexData, uint32_t indexCount, vk::IndexType indexType, const glm::vec4& boundingSphere);
+    [[nodiscard]] uint32_t get_mesh_index(WMeshHandle mesh) const;
+
+    WPipelineHandle add_pipeline(vk::raii::Pipeline&& pipeline, vk::PipelineBindPoint bindPoint);
+    void destroy_pipeline(WPipelineHandle& pipeline);
+    void bind_pipeline(const vk::raii::CommandBuffer& commandBuffer, WPipelineHandle pipeline) const;
 
     void cleanup_swap_chain();
     void recreate_swap_chain();
-
-    void record_command_buffer(uint32_t imageIndex) const;
+    /** Returns the retired handle, it stays valid until the deletion queue gets to it **/
+    vk::SwapchainKHR retire_swap_chain();
+    void destroy_retired_swap_chain(WRetiredSwapChain& retired) const;
+
+    void record_command_buffer(uint32_t imageIndex);
+    /** Records the cpu draws on the record slots and returns the number of secondaries, 0 if it wasn't worth splitting **/
+    uint32_t record_draws_parallel();
+    void bind_draw_state(const vk::raii::CommandBuffer& commandBuffer) const;
+    void record_draw_range(const vk::raii::CommandBuffer& commandBuffer, uint32_t firstDraw, uint32_t drawCount) const;
+    void record_cull_pass(uint32_t objectCount);
     void transition_image_layout(uint32_t imageIndex, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::AccessFlags2 srcAccessMask, vk::AccessFlags2 dstAccessMask, vk::PipelineStageFlags2 srcStageMask, vk::PipelineStageFlags2 dstStageMask) const;
 
+    /** Lists the buffers, images and textures their owners never destroyed, before destroy_vulkan sweeps them up **/
+    void report_memory_leaks() const;
     void destroy_vulkan();
 
-    std::vector<const char*> device_extensions = {
-        vk::KHRSwapchainExtensionName
-    };
+    std::vector<const char*> device_extensions;
 
-    bool frame_buffer_resized = false;
+    // written by the glfw callback on the window thread, read by whichever thread draws the frames
+    std::atomic<bool> frame_buffer_resized = false;
+    std::atomic<uint32_t> framebuffer_width = 0;
+    std::atomic<uint32_t> framebuffer_height = 0;
+    std::thread::id window_thread;
     static void frame_buffer_resize_callback(GLFWwindow* window, int width, int height);
 
     static VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type, const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData, void*);
 };
 
-struct Vertex
-{
-    glm::vec2 position;
-    glm::vec3 color;
-
-    static constexpr vk::VertexInputBindingDescription GetBindingDescription()
-    {
-        return { 0, sizeof(Vertex), vk::VertexInputRate::eVertex };
-    }
-
-    static constexpr std::array<vk::VertexInputAttributeDescription, 2> GetAttributeDescriptions()
-    {
-        return {
-            vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32Sfloat, offsetof(Vertex, position)),
-            vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color))
-        };
-    }
-};
-
-struct UniformBufferObject
-{
-    glm::mat4 model;
-    glm::mat4 view;
-    glm::mat4 projection;
-};
-
 vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
-vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, GLFWwindow* window);
+vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, vk::Extent2D framebufferExtent);
 uint32_t chooseSwapMinImageCount(const vk::SurfaceCapabilitiesKHR& swapSurfaceCapabilities);
 vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
-std::vector<char> readShaderFile(const std::string& filename);
+bool isPipelineCacheCompatible(const std::vector<char>& cacheData, const vk::PhysicalDeviceProperties& properties);
 
 const std::vector<Vertex> vertices = {
-    {{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-    {{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
-    {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
-    {{-0.5f, 0.5f}, {1.0f, 0.0f, 1.0f}}
+    {{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+    {{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+    {{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+    {{-0.5f, 0.5f, 0.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f}}
 };
 
 const std::vector<uint32_t> indices = {
@@ -0,0 +1,46 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include "WVulkan.h"
+
+/** Tracks device local memory against the budget the driver reports through VK_EXT_memory_budget, or against a fixed ceiling below it,
+    so streamed resources can be shrunk before an allocation fails. Without the extension VMA estimates the budget from its own allocations.
+    Only the numbers live here, what to evict is up to the owner of the resources. **/
+class WResidencyManager
+{
+public:
+    /** Shrinking starts above the high watermark and frees down to the low one, growing never goes past the low one **/
+    static constexpr double HIGH_WATERMARK = 0.95;
+    static constexpr double LOW_WATERMARK = 0.85;
+
+    void Init(VmaAllocator _allocator, const vk::raii::PhysicalDevice& physicalDevice);
+
+    /** 0 leaves it to the driver budget, otherwise whichever is smaller applies. For several instances sharing a gpu **/
+    void SetCeiling(vk::DeviceSize bytes);
+    /** Queries the heap budgets, once per frame is enough **/
+    void Update();
+
+    /** Memory that's still allocated but already on its way out, e.g. waiting for the frames in flight, isn't freed again **/
+    void BeginRelease(vk::DeviceSize bytes);
+    void EndRelease(vk::DeviceSize bytes);
+
+    /** Device local bytes in use as of the last Update, minus what's being released **/
+    [[nodiscard]] vk::DeviceSize GetUsage() const;
+    [[nodiscard]] vk::DeviceSize GetBudget() const;
+    /** Bytes to free to get back to the low watermark, 0 as long as usage is under the high one **/
+    [[nodiscard]] vk::DeviceSize GetExcess() const;
+    /** Bytes that can still be allocated before reaching the low watermark **/
+    [[nodiscard]] vk::DeviceSize GetHeadroom() const;
+
+private:
+    VmaAllocator allocator = nullptr;
+    uint32_t heap_count = 0;
+    uint32_t device_local_heaps = 0;
+
+    vk::DeviceSize ceiling = 0;
+    vk::DeviceSize usage = 0;
+    vk::DeviceSize budget = 0;
+    vk::DeviceSize releasing = 0;
+};
@@ -0,0 +1,68 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/** A slang module and the entry points that go into one SPIR-V binary, like a wyrm_embed_shader call in the build **/
+struct WShaderProgram
+{
+    std::string module;
+    std::vector<std::string> entry_points;
+};
+
+struct WCompiledShader
+{
+    /** Index into the programs passed to Start **/
+    uint32_t program = 0;
+    std::vector<uint32_t> spirv;
+};
+
+/** Watches the shader sources on a background thread and recompiles every program through the slang API once one of them changes.
+    Only does anything in builds configured with WYRM_SHADER_HOT_RELOAD, Start is a no-op otherwise.
+    Failed compiles print their diagnostics and are dropped, so the last working binary stays in use. **/
+class WShaderHotReload
+{
+public:
+    WShaderHotReload() = default;
+    WShaderHotReload(const WShaderHotReload&) = delete;
+    WShaderHotReload& operator=(const WShaderHotReload&) = delete;
+    ~WShaderHotReload();
+
+    void Start(const std::filesystem::path& _sourceDirectory, std::vector<WShaderProgram> _programs);
+    void Stop();
+
+    /** Programs that finished compiling since the last call, safe to call from any thread **/
+    [[nodiscard]] std::vector<WCompiledShader> TakeCompiled();
+    [[nodiscard]] static bool IsAvailable();
+
+private:
+    static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+    std::filesystem::path source_directory;
+    std::vector<WShaderProgram> programs;
+    std::unordered_map<std::string, std::filesystem::file_time_type> write_times;
+
+    std::thread watcher;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    std::vector<WCompiledShader> compiled;
+    std::atomic<bool> has_compiled = false;
+
+    void watch_loop();
+    /** True if any source was added, removed or written since the last call **/
+    bool scan_sources();
+    void compile_all();
+};
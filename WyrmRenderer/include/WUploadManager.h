@@ -0,0 +1,99 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <deque>
+
+#include "WAllocationTracker.h"
+#include "WVulkan.h"
+
+/** Batches buffer and image uploads through a persistently mapped staging ring and submits them once per frame on the transfer queue.
+    Completion is tracked with a timeline semaphore, consumers wait on the value returned by Flush instead of idling a queue.
+    Not thread safe, everything has to be called from the thread that drives the renderer. **/
+class WUploadManager
+{
+public:
+    static constexpr vk::DeviceSize DEFAULT_STAGING_SIZE = 64ull * 1024 * 1024;
+
+    void Init(const vk::raii::Device& _device, VmaAllocator _allocator, WAllocationTracker& _tracker, uint32_t _queueFamilyIndex, vk::DeviceSize stagingSize = DEFAULT_STAGING_SIZE);
+    void Destroy();
+
+    /** Copies the data into the staging ring right away, the gpu copy is recorded by the next Flush.
+        Blocks only if the ring is full and the oldest batch has not finished yet **/
+    void EnqueueBufferUpload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size);
+    /** Uploads one tightly packed mip level of a 2D color image, block compressed data is copied as is.
+        The level goes from undefined to eShaderReadOnlyOptimal, big levels are split on rows of blocks.
+        Assumes the transfer queue copies at single texel granularity **/
+    void EnqueueImageUpload(vk::Image dstImage, vk::Format format, uint32_t mipLevel, vk::Extent2D extent, const void* data, vk::DeviceSize size);
+
+    /** Submits everything queued since the last flush as one batch and returns the timeline value that signals its completion **/
+    uint64_t Flush();
+    void WaitForValue(uint64_t value) const;
+
+    [[nodiscard]] uint64_t GetCompletedValue() const;
+    [[nodiscard]] uint64_t GetLastSubmittedValue() const;
+    [[nodiscard]] vk::Semaphore GetTimelineSemaphore() const;
+    [[nodiscard]] uint32_t GetQueueFamilyIndex() const;
+
+private:
+    static constexpr uint32_t BATCH_COUNT = 8;
+
+    struct PendingCopy
+    {
+        vk::Buffer dst_buffer;
+        vk::DeviceSize src_offset;
+        vk::DeviceSize dst_offset;
+        vk::DeviceSize size;
+    };
+
+    struct PendingImageCopy
+    {
+        vk::Image dst_image;
+        vk::BufferImageCopy region;
+        /** The first chunk of a level moves it to eTransferDstOptimal, the last one on to eShaderReadOnlyOptimal **/
+        bool first;
+        bool last;
+    };
+
+    struct InFlightBatch
+    {
+        uint64_t timeline_value;
+        uint64_t ring_end;
+    };
+
+    const vk::raii::Device* device = nullptr;
+    VmaAllocator allocator = nullptr;
+    WAllocationTracker* tracker = nullptr;
+    uint32_t queue_family_index = ~0u;
+
+    vk::raii::Queue queue = nullptr;
+    vk::raii::CommandPool command_pool = nullptr;
+    std::vector<vk::raii::CommandBuffer> command_buffers;
+    std::array<uint64_t, BATCH_COUNT> command_buffer_values {};
+    uint32_t next_command_buffer = 0;
+
+    vk::raii::Semaphore timeline = nullptr;
+    uint64_t last_submitted_value = 0;
+
+    vk::Buffer staging_buffer = nullptr;
+    VmaAllocation staging_allocation = nullptr;
+    std::byte* staging_mapped = nullptr;
+    vk::DeviceSize staging_capacity = 0;
+
+    // monotonic positions in the ring, position % staging_capacity is the offset into the buffer
+    uint64_t ring_head = 0;
+    uint64_t ring_tail = 0;
+
+    std::vector<PendingCopy> pending_copies;
+    std::vector<vk::BufferCopy> copy_regions;
+    std::vector<PendingImageCopy> pending_image_copies;
+    std::vector<vk::ImageMemoryBarrier2> image_barriers;
+    std::vector<vk::BufferImageCopy> image_regions;
+    std::deque<InFlightBatch> in_flight;
+
+    vk::DeviceSize allocate_staging(vk::DeviceSize size);
+    void record_image_copies(const vk::raii::CommandBuffer& commandBuffer);
+    void release_completed(bool waitForOldest);
+};
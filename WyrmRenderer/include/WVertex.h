@@ -0,0 +1,30 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "WVulkan.h"
+
+/** The one vertex layout of the geometry pool, cooked meshes store their vertices in exactly this layout **/
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+    glm::vec2 uv;
+
+    static constexpr vk::VertexInputBindingDescription GetBindingDescription()
+    {
+        return { 0, sizeof(Vertex), vk::VertexInputRate::eVertex };
+    }
+
+    static constexpr std::array<vk::VertexInputAttributeDescription, 3> GetAttributeDescriptions()
+    {
+        return {
+            vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)),
+            vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color)),
+            vk::VertexInputAttributeDescription(2, 0, vk::Format::eR32G32Sfloat, offsetof(Vertex, uv))
+        };
+    }
+};
@@ -0,0 +1,19 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan_raii.hpp>
+
+struct VmaAllocator_T;
+using VmaAllocator = VmaAllocator_T*;
+
+struct VmaAllocation_T;
+using VmaAllocation = VmaAllocation_T*;
+
+struct VmaVirtualBlock_T;
+using VmaVirtualBlock = VmaVirtualBlock_T*;
+
+struct VmaVirtualAllocation_T;
+using VmaVirtualAllocation = VmaVirtualAllocation_T*;
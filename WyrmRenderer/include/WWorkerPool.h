@@ -0,0 +1,49 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Runs task(0) to task(count - 1) spread over the available threads and returns once all of them finished **/
+using WParallelFor = std::function<void(uint32_t count, const std::function<void(uint32_t index)>& task)>;
+
+/** Small fixed thread pool the renderer falls back to when nobody installed a WParallelFor.
+    The calling thread works on the tasks as well instead of only waiting. **/
+class WWorkerPool
+{
+public:
+    WWorkerPool() = default;
+    WWorkerPool(const WWorkerPool&) = delete;
+    WWorkerPool& operator=(const WWorkerPool&) = delete;
+    ~WWorkerPool();
+
+    void Start(uint32_t workerCount);
+    void Stop();
+
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& task);
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    uint64_t generation = 0;
+    uint32_t active_workers = 0;
+
+    // only written while no worker is active
+    const std::function<void(uint32_t)>* current_task = nullptr;
+    uint32_t task_count = 0;
+    std::atomic<uint32_t> next_index = 0;
+    std::atomic<uint32_t> finished_count = 0;
+
+    void worker_loop();
+    void run_tasks();
+};
@@ -0,0 +1,172 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WAllocationTracker.h"
+
+#include "vk_mem_alloc.h"
+
+#include <nlohmann/json.hpp>
+#include <ranges>
+
+const char* allocationCategoryName(const WAllocationCategory category)
+{
+    switch (category)
+    {
+    case ALLOCATION_MESH: return "mesh";
+    case ALLOCATION_UNIFORM: return "uniform";
+    case ALLOCATION_STAGING: return "staging";
+    case ALLOCATION_TEXTURE: return "texture";
+    case ALLOCATION_RENDER_TARGET: return "render_target";
+    case ALLOCATION_INDIRECT: return "indirect";
+    case ALLOCATION_BUFFER: return "buffer";
+    case ALLOCATION_IMAGE: return "image";
+    default: return "unknown";
+    }
+}
+
+void WAllocationTracker::Init(VmaAllocator _allocator)
+{
+    allocator = _allocator;
+}
+
+void WAllocationTracker::Destroy()
+{
+    std::lock_guard lock(mutex);
+    entries.clear();
+    categories = {};
+    allocator = nullptr;
+}
+
+void WAllocationTracker::Track(const VmaAllocation allocation, const WAllocationCategory category, const std::string_view name)
+{
+    const std::string qualifiedName = std::string(allocationCategoryName(category)) + "/" + std::string(name);
+    vmaSetAllocationName(allocator, allocation, qualifiedName.c_str());
+
+    VmaAllocationInfo allocationI;
+    vmaGetAllocationInfo(allocator, allocation, &allocationI);
+
+    std::lock_guard lock(mutex);
+    entries[allocation] = {.category = category, .name = std::string(name), .size = allocationI.size};
+    categories[category].allocation_count++;
+    categories[category].bytes += allocationI.size;
+}
+
+void WAllocationTracker::DestroyBuffer(const vk::Buffer buffer, const VmaAllocation allocation)
+{
+    untrack(allocation);
+    vmaDestroyBuffer(allocator, buffer, allocation);
+}
+
+void WAllocationTracker::DestroyImage(const vk::Image image, const VmaAllocation allocation)
+{
+    untrack(allocation);
+    vmaDestroyImage(allocator, image, allocation);
+}
+
+WMemoryStats WAllocationTracker::GetStats() const
+{
+    const VkPhysicalDeviceMemoryProperties* memoryProperties;
+    vmaGetMemoryProperties(allocator, &memoryProperties);
+    VmaTotalStatistics totalStatistics;
+    vmaCalculateStatistics(allocator, &totalStatistics);
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets {};
+    vmaGetHeapBudgets(allocator, heapBudgets.data());
+
+    WMemoryStats stats;
+    for (uint32_t heap = 0; heap < memoryProperties->memoryHeapCount; heap++)
+    {
+        const VmaDetailedStatistics& heapStatistics = totalStatistics.memoryHeap[heap];
+        const vk::DeviceSize unusedBytes = heapStatistics.statistics.blockBytes - heapStatistics.statistics.allocationBytes;
+        stats.heaps.push_back({
+            .device_local = (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            .budget = heapBudgets[heap].budget,
+            .usage = heapBudgets[heap].usage,
+            .block_bytes = heapStatistics.statistics.blockBytes,
+            .allocation_bytes = heapStatistics.statistics.allocationBytes,
+            .block_count = heapStatistics.statistics.blockCount,
+            .allocation_count = heapStatistics.statistics.allocationCount,
+            // share of the free space outside the largest free range, what an allocation of all of it would fail on
+            .fragmentation = unusedBytes > 0 && heapStatistics.unusedRangeCount > 0
+                ? 1.f - static_cast<float>(static_cast<double>(heapStatistics.unusedRangeSizeMax) / static_cast<double>(unusedBytes))
+                : 0.f
+        });
+    }
+
+    std::lock_guard lock(mutex);
+    stats.categories = categories;
+    return stats;
+}
+
+uint32_t WAllocationTracker::GetTrackedCount() const
+{
+    std::lock_guard lock(mutex);
+    return static_cast<uint32_t>(entries.size());
+}
+
+std::vector<WAllocationTracker::Entry> WAllocationTracker::GetTracked() const
+{
+    std::lock_guard lock(mutex);
+    std::vector<Entry> tracked;
+    tracked.reserve(entries.size());
+    for (const auto& entry : entries | std::views::values)
+        tracked.push_back(entry);
+    return tracked;
+}
+
+WAllocationTracker::Entry WAllocationTracker::Find(const VmaAllocation allocation) const
+{
+    std::lock_guard lock(mutex);
+    const auto it = entries.find(allocation);
+    return it != entries.end() ? it->second : Entry {};
+}
+
+std::string WAllocationTracker::BuildReport(const bool detailed, const std::span<const Entry> leaks) const
+{
+    char* vmaStats = nullptr;
+    vmaBuildStatsString(allocator, &vmaStats, detailed ? VK_TRUE : VK_FALSE);
+    nlohmann::json report;
+    report["vma"] = nlohmann::json::parse(vmaStats);
+    vmaFreeStatsString(allocator, vmaStats);
+
+    const WMemoryStats stats = GetStats();
+    report["heaps"] = nlohmann::json::array();
+    for (const auto& heap : stats.heaps)
+        report["heaps"].push_back({
+            {"device_local", heap.device_local},
+            {"budget", heap.budget},
+            {"usage", heap.usage},
+            {"block_bytes", heap.block_bytes},
+            {"allocation_bytes", heap.allocation_bytes},
+            {"block_count", heap.block_count},
+            {"allocation_count", heap.allocation_count},
+            {"fragmentation", heap.fragmentation}
+        });
+
+    report["categories"] = nlohmann::json::object();
+    for (uint32_t category = 0; category < ALLOCATION_CATEGORY_COUNT; category++)
+        report["categories"][allocationCategoryName(static_cast<WAllocationCategory>(category))] = {
+            {"allocation_count", stats.categories[category].allocation_count},
+            {"bytes", stats.categories[category].bytes}
+        };
+
+    report["leaks"] = nlohmann::json::array();
+    for (const auto& leak : leaks)
+        report["leaks"].push_back({
+            {"name", leak.name},
+            {"category", allocationCategoryName(leak.category)},
+            {"bytes", leak.size}
+        });
+    return report.dump(2);
+}
+
+void WAllocationTracker::untrack(const VmaAllocation allocation)
+{
+    std::lock_guard lock(mutex);
+    const auto it = entries.find(allocation);
+    if (it == entries.end()) return;
+
+    categories[it->second.category].allocation_count--;
+    categories[it->second.category].bytes -= it->second.size;
+    entries.erase(it);
+}
@@ -0,0 +1,195 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WBindlessHeap.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "WRenderer.h"
+
+void WBindlessHeap::Init(const vk::raii::Device& _device, const vk::raii::PhysicalDevice& physicalDevice,
+                         const uint32_t bufferCapacity, const uint32_t imageCapacity, const uint32_t samplerCapacity)
+{
+    device = &_device;
+
+    const auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>()
+        .get<vk::PhysicalDeviceVulkan12Properties>();
+    buffers = {.capacity = std::min({bufferCapacity, properties.maxDescriptorSetUpdateAfterBindStorageBuffers, properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers})};
+    images = {.capacity = std::min({imageCapacity, properties.maxDescriptorSetUpdateAfterBindSampledImages, properties.maxPerStageDescriptorUpdateAfterBindSampledImages})};
+    samplers = {.capacity = std::min({samplerCapacity, properties.maxDescriptorSetUpdateAfterBindSamplers, properties.maxPerStageDescriptorUpdateAfterBindSamplers})};
+
+    const std::array layoutBindings {
+        vk::DescriptorSetLayoutBinding {
+            .binding = STORAGE_BUFFER_BINDING,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = buffers.capacity,
+            .stageFlags = vk::ShaderStageFlagBits::eAll
+        },
+        vk::DescriptorSetLayoutBinding {
+            .binding = SAMPLED_IMAGE_BINDING,
+            .descriptorType = vk::DescriptorType::eSampledImage,
+            .descriptorCount = images.capacity,
+            .stageFlags = vk::ShaderStageFlagBits::eAll
+        },
+        vk::DescriptorSetLayoutBinding {
+            .binding = SAMPLER_BINDING,
+            .descriptorType = vk::DescriptorType::eSampler,
+            .descriptorCount = samplers.capacity,
+            .stageFlags = vk::ShaderStageFlagBits::eAll
+        }
+    };
+
+    // partially bound lets unused slots stay unwritten, update unused while pending lets new slots be written while frames are in flight
+    constexpr vk::DescriptorBindingFlags bindingFlags =
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+    const std::array allBindingFlags {bindingFlags, bindingFlags, bindingFlags};
+    const vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCI {
+        .bindingCount = static_cast<uint32_t>(allBindingFlags.size()),
+        .pBindingFlags = allBindingFlags.data()
+    };
+    const vk::DescriptorSetLayoutCreateInfo layoutCI {
+        .pNext = &bindingFlagsCI,
+        .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        .bindingCount = static_cast<uint32_t>(layoutBindings.size()),
+        .pBindings = layoutBindings.data()
+    };
+    layout = {_device, layoutCI};
+
+    const std::array poolSizes {
+        vk::DescriptorPoolSize {.type = vk::DescriptorType::eStorageBuffer, .descriptorCount = buffers.capacity},
+        vk::DescriptorPoolSize {.type = vk::DescriptorType::eSampledImage, .descriptorCount = images.capacity},
+        vk::DescriptorPoolSize {.type = vk::DescriptorType::eSampler, .descriptorCount = samplers.capacity}
+    };
+    const vk::DescriptorPoolCreateInfo poolCI {
+        .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet | vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    };
+    pool = {_device, poolCI};
+
+    const vk::DescriptorSetAllocateInfo setAllocI {
+        .descriptorPool = pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &*layout
+    };
+    set = std::move(_device.allocateDescriptorSets(setAllocI).front());
+}
+
+void WBindlessHeap::Destroy()
+{
+    set = nullptr;
+    pool = nullptr;
+    layout = nullptr;
+    buffers = {};
+    images = {};
+    samplers = {};
+    device = nullptr;
+}
+
+WBindlessIndex WBindlessHeap::RegisterBuffer(const vk::Buffer buffer, const vk::DeviceSize offset, const vk::DeviceSize range)
+{
+    const WBindlessIndex index = buffers.Allocate("storage buffers");
+
+    const vk::DescriptorBufferInfo bufferI {
+        .buffer = buffer,
+        .offset = offset,
+        .range = range
+    };
+    const vk::WriteDescriptorSet write {
+        .dstSet = *set,
+        .dstBinding = STORAGE_BUFFER_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &bufferI
+    };
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+WBindlessIndex WBindlessHeap::RegisterImage(const vk::ImageView view, const vk::ImageLayout layout)
+{
+    const WBindlessIndex index = images.Allocate("sampled images");
+
+    const vk::DescriptorImageInfo imageI {
+        .imageView = view,
+        .imageLayout = layout
+    };
+    const vk::WriteDescriptorSet write {
+        .dstSet = *set,
+        .dstBinding = SAMPLED_IMAGE_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampledImage,
+        .pImageInfo = &imageI
+    };
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+WBindlessIndex WBindlessHeap::RegisterSampler(const vk::Sampler sampler)
+{
+    const WBindlessIndex index = samplers.Allocate("samplers");
+
+    const vk::DescriptorImageInfo samplerI {.sampler = sampler};
+    const vk::WriteDescriptorSet write {
+        .dstSet = *set,
+        .dstBinding = SAMPLER_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampler,
+        .pImageInfo = &samplerI
+    };
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+void WBindlessHeap::FreeBuffer(const WBindlessIndex index)
+{
+    buffers.Free(index);
+}
+
+void WBindlessHeap::FreeImage(const WBindlessIndex index)
+{
+    images.Free(index);
+}
+
+void WBindlessHeap::FreeSampler(const WBindlessIndex index)
+{
+    samplers.Free(index);
+}
+
+vk::DescriptorSetLayout WBindlessHeap::GetLayout() const
+{
+    return *layout;
+}
+
+vk::DescriptorSet WBindlessHeap::GetSet() const
+{
+    return *set;
+}
+
+uint32_t WBindlessHeap::IndexList::Allocate(const char* kind)
+{
+    if (!free.empty())
+    {
+        const uint32_t index = free.back();
+        free.pop_back();
+        return index;
+    }
+
+    if (next == capacity)
+        WRenderer::WThrowException(std::string("the bindless heap is out of ") + kind);
+    return next++;
+}
+
+void WBindlessHeap::IndexList::Free(const uint32_t index)
+{
+    assert(index < next);
+    free.push_back(index);
+}
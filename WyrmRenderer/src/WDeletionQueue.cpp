@@ -0,0 +1,36 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WDeletionQueue.h"
+
+void WDeletionQueue::Push(const uint64_t timelineValue, std::function<void()> deleter)
+{
+    pending.push_back({timelineValue, std::move(deleter)});
+}
+
+void WDeletionQueue::Collect(const uint64_t completedValue)
+{
+    while (!pending.empty() && pending.front().timeline_value <= completedValue)
+    {
+        // popped first, a deleter may push again
+        const auto deleter = std::move(pending.front().deleter);
+        pending.pop_front();
+        deleter();
+    }
+}
+
+void WDeletionQueue::Flush()
+{
+    while (!pending.empty())
+    {
+        const auto deleter = std::move(pending.front().deleter);
+        pending.pop_front();
+        deleter();
+    }
+}
+
+size_t WDeletionQueue::GetPendingCount() const
+{
+    return pending.size();
+}
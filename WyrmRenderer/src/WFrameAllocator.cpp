@@ -0,0 +1,100 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WFrameAllocator.h"
+
+#include "vk_mem_alloc.h"
+
+#include <algorithm>
+
+#include "WRenderer.h"
+
+void WFrameAllocator::Init(VmaAllocator _allocator, WAllocationTracker& _tracker, const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const vk::BufferUsageFlags usage, const uint32_t framesInFlight, const vk::DeviceSize frameSize)
+{
+    allocator = _allocator;
+    tracker = &_tracker;
+
+    const auto limits = physicalDevice.getProperties().limits;
+    alignment = 1;
+    if (usage & vk::BufferUsageFlagBits::eUniformBuffer)
+        alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+    if (usage & vk::BufferUsageFlagBits::eStorageBuffer)
+        alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+    frame_size = (frameSize + alignment - 1) / alignment * alignment;
+
+    // dynamic offsets are 32 bit
+    if (frame_size * framesInFlight > UINT32_MAX)
+        WRenderer::WThrowException("frame allocator is too big for dynamic offsets");
+
+    const vk::BufferCreateInfo bufferCI {
+        .size = frame_size * framesInFlight,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive
+    };
+    // sequential write lets VMA pick device local host visible memory where it exists instead of a readback heap
+    constexpr VmaAllocationCreateInfo allocationCI {
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO
+    };
+    VmaAllocationInfo allocationI;
+    if (const VkResult result = vmaCreateBuffer(allocator, &*bufferCI, &allocationCI, reinterpret_cast<VkBuffer*>(&buffer), &allocation, &allocationI); result != VK_SUCCESS)
+        WRenderer::WThrowException("failed to create the frame allocator buffer: " + vk::to_string(static_cast<vk::Result>(result)));
+    tracker->Track(allocation, ALLOCATION_UNIFORM, "frame allocator");
+
+    mapped = static_cast<std::byte*>(allocationI.pMappedData);
+    if (usage & vk::BufferUsageFlagBits::eShaderDeviceAddress)
+        device_address = device.getBufferAddress({.buffer = buffer});
+    frame_begin = 0;
+    frame_offset = 0;
+}
+
+void WFrameAllocator::Destroy()
+{
+    if (!allocator) return;
+
+    tracker->DestroyBuffer(buffer, allocation);
+    buffer = nullptr;
+    allocation = nullptr;
+    mapped = nullptr;
+    device_address = 0;
+    allocator = nullptr;
+}
+
+void WFrameAllocator::BeginFrame(const uint32_t frameIndex)
+{
+    frame_begin = frame_size * frameIndex;
+    frame_offset = 0;
+}
+
+void WFrameAllocator::Flush() const
+{
+    if (frame_offset > 0)
+        vmaFlushAllocation(allocator, allocation, frame_begin, frame_offset);
+}
+
+WFrameSlice WFrameAllocator::Allocate(const vk::DeviceSize size)
+{
+    const vk::DeviceSize offset = frame_offset;
+    const vk::DeviceSize end = offset + (size + alignment - 1) / alignment * alignment;
+    if (end > frame_size)
+        WRenderer::WThrowException("frame allocator is out of space");
+
+    frame_offset = end;
+    return {
+        .buffer = buffer,
+        .offset = static_cast<uint32_t>(frame_begin + offset),
+        .mapped = mapped + frame_begin + offset,
+        .address = device_address ? device_address + frame_begin + offset : 0
+    };
+}
+
+vk::Buffer WFrameAllocator::GetBuffer() const
+{
+    return buffer;
+}
+
+vk::DeviceSize WFrameAllocator::GetUsedBytes() const
+{
+    return frame_offset;
+}
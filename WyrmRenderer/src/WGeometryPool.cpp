@@ -0,0 +1,149 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WGeometryPool.h"
+
+#include "vk_mem_alloc.h"
+
+#include "WRenderer.h"
+
+void WGeometryPool::Init(VmaAllocator _allocator, WAllocationTracker& _tracker, const uint32_t vertexStride, const uint32_t vertexCapacity, const uint32_t indexCapacity, const std::vector<uint32_t>& queueFamilies)
+{
+    allocator = _allocator;
+    tracker = &_tracker;
+    vertex_stride = vertexStride;
+
+    // storage and device address usage lets compute passes read the geometry directly
+    constexpr vk::BufferUsageFlags sharedUsage =
+        vk::BufferUsageFlagBits::eTransferDst |
+        vk::BufferUsageFlagBits::eStorageBuffer |
+        vk::BufferUsageFlagBits::eShaderDeviceAddress;
+    create_buffer(static_cast<vk::DeviceSize>(vertexCapacity) * vertexStride, vk::BufferUsageFlagBits::eVertexBuffer | sharedUsage, queueFamilies, "geometry pool vertices", vertex_buffer, vertex_buffer_alloc);
+    create_buffer(static_cast<vk::DeviceSize>(indexCapacity) * sizeof(uint32_t), vk::BufferUsageFlagBits::eIndexBuffer | sharedUsage, queueFamilies, "geometry pool indices", index_buffer, index_buffer_alloc);
+
+    // the virtual blocks count elements instead of bytes, so every offset they hand out is already a vertex or index offset
+    const VmaVirtualBlockCreateInfo vertexBlockCI {.size = vertexCapacity};
+    const VmaVirtualBlockCreateInfo indexBlockCI {.size = indexCapacity};
+    if (vmaCreateVirtualBlock(&vertexBlockCI, &vertex_block) != VK_SUCCESS ||
+        vmaCreateVirtualBlock(&indexBlockCI, &index_block) != VK_SUCCESS)
+        WRenderer::WThrowException("failed to create the geometry pool blocks");
+}
+
+void WGeometryPool::Destroy()
+{
+    if (!allocator) return;
+
+    // ranges that were never freed die with the pool
+    vmaClearVirtualBlock(vertex_block);
+    vmaClearVirtualBlock(index_block);
+    vmaDestroyVirtualBlock(vertex_block);
+    vmaDestroyVirtualBlock(index_block);
+    vertex_block = nullptr;
+    index_block = nullptr;
+
+    tracker->DestroyBuffer(index_buffer, index_buffer_alloc);
+    tracker->DestroyBuffer(vertex_buffer, vertex_buffer_alloc);
+    vertex_buffer = nullptr;
+    index_buffer = nullptr;
+
+    used_vertices = 0;
+    used_indices = 0;
+    allocator = nullptr;
+}
+
+WGeometryRange WGeometryPool::Allocate(const uint32_t vertexCount, const uint32_t indexCount)
+{
+    WGeometryRange range {.vertex_count = vertexCount, .index_count = indexCount};
+
+    VkDeviceSize vertexOffset = 0;
+    const VmaVirtualAllocationCreateInfo vertexAllocCI {.size = vertexCount};
+    if (vmaVirtualAllocate(vertex_block, &vertexAllocCI, &range.vertex_alloc, &vertexOffset) != VK_SUCCESS)
+        WRenderer::WThrowException("geometry pool is out of vertex space");
+
+    VkDeviceSize indexOffset = 0;
+    const VmaVirtualAllocationCreateInfo indexAllocCI {.size = indexCount};
+    if (vmaVirtualAllocate(index_block, &indexAllocCI, &range.index_alloc, &indexOffset) != VK_SUCCESS)
+    {
+        vmaVirtualFree(vertex_block, range.vertex_alloc);
+        WRenderer::WThrowException("geometry pool is out of index space");
+    }
+
+    range.vertex_offset = static_cast<uint32_t>(vertexOffset);
+    range.first_index = static_cast<uint32_t>(indexOffset);
+    used_vertices += vertexCount;
+    used_indices += indexCount;
+    return range;
+}
+
+void WGeometryPool::Free(WGeometryRange& range)
+{
+    if (range.vertex_alloc)
+        vmaVirtualFree(vertex_block, range.vertex_alloc);
+    if (range.index_alloc)
+        vmaVirtualFree(index_block, range.index_alloc);
+
+    used_vertices -= range.vertex_count;
+    used_indices -= range.index_count;
+    range = {};
+}
+
+void WGeometryPool::CmdBind(const vk::raii::CommandBuffer& commandBuffer) const
+{
+    commandBuffer.bindVertexBuffers(0, vertex_buffer, {0});
+    CmdBindIndexBuffer(commandBuffer, vk::IndexType::eUint32);
+}
+
+void WGeometryPool::CmdBindIndexBuffer(const vk::raii::CommandBuffer& commandBuffer, const vk::IndexType indexType) const
+{
+    commandBuffer.bindIndexBuffer(index_buffer, 0, indexType);
+}
+
+vk::Buffer WGeometryPool::GetVertexBuffer() const
+{
+    return vertex_buffer;
+}
+
+vk::Buffer WGeometryPool::GetIndexBuffer() const
+{
+    return index_buffer;
+}
+
+vk::DeviceSize WGeometryPool::GetVertexByteOffset(const WGeometryRange& range) const
+{
+    return static_cast<vk::DeviceSize>(range.vertex_offset) * vertex_stride;
+}
+
+vk::DeviceSize WGeometryPool::GetIndexByteOffset(const WGeometryRange& range)
+{
+    return static_cast<vk::DeviceSize>(range.first_index) * sizeof(uint32_t);
+}
+
+uint32_t WGeometryPool::GetUsedVertexCount() const
+{
+    return used_vertices;
+}
+
+uint32_t WGeometryPool::GetUsedIndexCount() const
+{
+    return used_indices;
+}
+
+void WGeometryPool::create_buffer(const vk::DeviceSize size, const vk::BufferUsageFlags usage, const std::vector<uint32_t>& queueFamilies, const std::string_view name, vk::Buffer& buffer, VmaAllocation& allocation) const
+{
+    const bool concurrent = queueFamilies.size() > 1;
+    const vk::BufferCreateInfo bufferCI {
+        .size = size,
+        .usage = usage,
+        .sharingMode = concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(queueFamilies.size()) : 0u,
+        .pQueueFamilyIndices = concurrent ? queueFamilies.data() : nullptr
+    };
+    constexpr VmaAllocationCreateInfo allocationCI {
+        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY
+    };
+    if (const VkResult result = vmaCreateBuffer(allocator, &*bufferCI, &allocationCI, reinterpret_cast<VkBuffer*>(&buffer), &allocation, nullptr); result != VK_SUCCESS)
+        WRenderer::WThrowException("failed to create a geometry pool buffer: " + vk::to_string(static_cast<vk::Result>(result)));
+    tracker->Track(allocation, ALLOCATION_MESH, name);
+}
@@ -0,0 +1,96 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WKtxTexture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ktx.h>
+
+#include "WRenderer.h"
+
+// the level index follows the fixed size part of the KTX2 header, one entry per level starting with level 0
+static constexpr uint64_t KTX2_LEVEL_INDEX_OFFSET = 80;
+
+struct Ktx2LevelIndexEntry
+{
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    uint64_t uncompressed_byte_length;
+};
+
+void WKtxTexture::Open(const std::filesystem::path& path)
+{
+    Close();
+
+    // without the load flag libktx only reads the header, the level index and the metadata
+    ktxTexture2* texture = nullptr;
+    const KTX_error_code result = ktxTexture2_CreateFromNamedFile(path.string().c_str(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture);
+    if (result != KTX_SUCCESS)
+        WRenderer::WThrowException("failed to read " + path.string() + ": " + ktxErrorString(result));
+
+    const bool supercompressed = texture->supercompressionScheme != KTX_SS_NONE || ktxTexture2_NeedsTranscoding(texture);
+    const bool singleImage = texture->numDimensions == 2 && texture->numLayers == 1 && texture->numFaces == 1 && !texture->isArray;
+    format = static_cast<vk::Format>(texture->vkFormat);
+    extent = vk::Extent2D {texture->baseWidth, texture->baseHeight};
+    const uint32_t levelCount = texture->numLevels;
+    ktxTexture_Destroy(ktxTexture(texture));
+
+    if (supercompressed)
+        WRenderer::WThrowException(path.string() + " is supercompressed, only data the gpu samples directly can be streamed");
+    if (!singleImage)
+        WRenderer::WThrowException(path.string() + " is not a single 2D image");
+    if (format == vk::Format::eUndefined)
+        WRenderer::WThrowException(path.string() + " has no vulkan format");
+
+    file.Open(path);
+    const std::span<const std::byte> data = file.GetData();
+    if (data.size() < KTX2_LEVEL_INDEX_OFFSET + levelCount * sizeof(Ktx2LevelIndexEntry))
+        WRenderer::WThrowException(path.string() + " is truncated");
+
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        Ktx2LevelIndexEntry entry;
+        memcpy(&entry, data.data() + KTX2_LEVEL_INDEX_OFFSET + level * sizeof(entry), sizeof(entry));
+        if (entry.byte_offset > data.size() || entry.byte_length > data.size() - entry.byte_offset)
+            WRenderer::WThrowException(path.string() + " is truncated");
+        levels.push_back(data.subspan(entry.byte_offset, entry.byte_length));
+    }
+}
+
+void WKtxTexture::Close()
+{
+    levels.clear();
+    file.Close();
+    format = vk::Format::eUndefined;
+    extent = vk::Extent2D {};
+}
+
+vk::Format WKtxTexture::GetFormat() const
+{
+    return format;
+}
+
+vk::Extent2D WKtxTexture::GetExtent(const uint32_t level) const
+{
+    return {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+}
+
+uint32_t WKtxTexture::GetLevelCount() const
+{
+    return static_cast<uint32_t>(levels.size());
+}
+
+std::span<const std::byte> WKtxTexture::GetLevel(const uint32_t level) const
+{
+    return levels[level];
+}
+
+vk::DeviceSize WKtxTexture::GetChainSize(const uint32_t baseLevel) const
+{
+    vk::DeviceSize size = 0;
+    for (uint32_t level = baseLevel; level < levels.size(); level++)
+        size += levels[level].size();
+    return size;
+}
@@ -0,0 +1,105 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WMappedFile.h"
+
+#include "WRenderer.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+WMappedFile::~WMappedFile()
+{
+    Close();
+}
+
+void WMappedFile::Open(const std::filesystem::path& path)
+{
+    Close();
+
+#ifdef _WIN32
+    file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        file = nullptr;
+        WRenderer::WThrowException("failed to open " + path.string());
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) return;
+
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        Close();
+        WRenderer::WThrowException("failed to map " + path.string());
+    }
+#else
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        WRenderer::WThrowException("failed to open " + path.string());
+
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        WRenderer::WThrowException("failed to stat " + path.string());
+    }
+    // mmap refuses empty files, an empty span is what the caller would get anyway
+    if (status.st_size == 0)
+    {
+        close(descriptor);
+        return;
+    }
+    size = static_cast<size_t>(status.st_size);
+
+    // the mapping keeps its own reference to the file, the descriptor isn't needed past this
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapped == MAP_FAILED)
+    {
+        size = 0;
+        WRenderer::WThrowException("failed to map " + path.string());
+    }
+    // read front to back once, straight into staging
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const std::byte*>(mapped);
+#endif
+}
+
+void WMappedFile::Close()
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data)
+        munmap(const_cast<std::byte*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+std::span<const std::byte> WMappedFile::GetData() const
+{
+    return {data, size};
+}
@@ -0,0 +1,500 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WMeshImport.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <tiny_gltf.h>
+
+#include "WRenderer.h"
+
+/** Entries of the post transform cache Tipsify plans for, small enough to hold on any gpu **/
+static constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct ImportGeometry
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// only geometry is imported, images are left undecoded
+static bool skipImage(tinygltf::Image*, int, std::string*, std::string*, int, int, const unsigned char*, int, void*)
+{
+    return true;
+}
+
+static float readComponent(const unsigned char* data, const int componentType, const bool normalized)
+{
+    switch (componentType)
+    {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:
+        {
+            float value;
+            memcpy(&value, data, sizeof(value));
+            return value;
+        }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        return normalized ? static_cast<float>(*data) / 255.f : static_cast<float>(*data);
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            memcpy(&value, data, sizeof(value));
+            return normalized ? static_cast<float>(value) / 65535.f : static_cast<float>(value);
+        }
+    default:
+        WRenderer::WThrowException("unsupported vertex component type " + std::to_string(componentType));
+        return 0.f;
+    }
+}
+
+/** Reads up to N floats of every element, missing components keep the value of fallback **/
+template<int N>
+static std::vector<glm::vec<N, float>> readAccessor(const tinygltf::Model& model, const int accessorIndex, const glm::vec<N, float> fallback)
+{
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+    if (accessor.sparse.isSparse || accessor.bufferView < 0)
+        WRenderer::WThrowException("sparse accessors and accessors without a buffer view aren't supported");
+
+    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+    const unsigned char* base = model.buffers[view.buffer].data.data() + view.byteOffset + accessor.byteOffset;
+    const int stride = accessor.ByteStride(view);
+    const int componentCount = std::min(tinygltf::GetNumComponentsInType(accessor.type), N);
+    const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+
+    std::vector<glm::vec<N, float>> elements(accessor.count, fallback);
+    for (size_t i = 0; i < accessor.count; i++)
+        for (int c = 0; c < componentCount; c++)
+            elements[i][c] = readComponent(base + i * stride + c * componentSize, accessor.componentType, accessor.normalized);
+    return elements;
+}
+
+static std::vector<uint32_t> readIndices(const tinygltf::Model& model, const tinygltf::Primitive& primitive, const size_t vertexCount)
+{
+    std::vector<uint32_t> indices;
+    if (primitive.indices < 0)
+    {
+        indices.resize(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++)
+            indices[i] = i;
+        return indices;
+    }
+
+    const tinygltf::Accessor& accessor = model.accessors[primitive.indices];
+    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+    const unsigned char* base = model.buffers[view.buffer].data.data() + view.byteOffset + accessor.byteOffset;
+    const int stride = accessor.ByteStride(view);
+
+    indices.resize(accessor.count);
+    for (size_t i = 0; i < accessor.count; i++)
+    {
+        const unsigned char* element = base + i * stride;
+        switch (accessor.componentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            indices[i] = *element;
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            {
+                uint16_t index;
+                memcpy(&index, element, sizeof(index));
+                indices[i] = index;
+                break;
+            }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            memcpy(&indices[i], element, sizeof(uint32_t));
+            break;
+        default:
+            WRenderer::WThrowException("unsupported index component type " + std::to_string(accessor.componentType));
+        }
+    }
+    return indices;
+}
+
+static glm::mat4 getNodeTransform(const tinygltf::Node& node)
+{
+    if (node.matrix.size() == 16)
+        return glm::mat4(glm::make_mat4(node.matrix.data()));
+
+    glm::mat4 transform(1.f);
+    if (node.translation.size() == 3)
+        transform = glm::translate(transform, glm::vec3(glm::make_vec3(node.translation.data())));
+    if (node.rotation.size() == 4)
+        transform *= glm::mat4_cast(glm::quat(static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]), static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2])));
+    if (node.scale.size() == 3)
+        transform = glm::scale(transform, glm::vec3(glm::make_vec3(node.scale.data())));
+    return transform;
+}
+
+static void appendPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive, const glm::mat4& transform, ImportGeometry& geometry)
+{
+    if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES)
+    {
+        std::cerr << "skipping a primitive that isn't a triangle list" << std::endl;
+        return;
+    }
+
+    const auto position = primitive.attributes.find("POSITION");
+    if (position == primitive.attributes.end())
+        return;
+
+    const auto positions = readAccessor<3>(model, position->second, glm::vec3(0.f));
+    std::vector<glm::vec3> colors;
+    if (const auto color = primitive.attributes.find("COLOR_0"); color != primitive.attributes.end())
+        colors = readAccessor<3>(model, color->second, glm::vec3(1.f));
+    std::vector<glm::vec2> uvs;
+    if (const auto uv = primitive.attributes.find("TEXCOORD_0"); uv != primitive.attributes.end())
+        uvs = readAccessor<2>(model, uv->second, glm::vec2(0.f));
+
+    const auto firstVertex = static_cast<uint32_t>(geometry.vertices.size());
+    for (size_t i = 0; i < positions.size(); i++)
+        geometry.vertices.push_back({
+            .position = glm::vec3(transform * glm::vec4(positions[i], 1.f)),
+            .color = i < colors.size() ? colors[i] : glm::vec3(1.f),
+            .uv = i < uvs.size() ? uvs[i] : glm::vec2(0.f)
+        });
+
+    // a mirroring transform turns the triangles inside out, flipping each one keeps the winding the pipeline culls by
+    const bool mirrored = glm::determinant(glm::mat3(transform)) < 0.f;
+    const std::vector<uint32_t> indices = readIndices(model, primitive, positions.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        geometry.indices.push_back(firstVertex + indices[i]);
+        geometry.indices.push_back(firstVertex + indices[mirrored ? i + 2 : i + 1]);
+        geometry.indices.push_back(firstVertex + indices[mirrored ? i + 1 : i + 2]);
+    }
+}
+
+static void appendNode(const tinygltf::Model& model, const int nodeIndex, const glm::mat4& parentTransform, ImportGeometry& geometry)
+{
+    const tinygltf::Node& node = model.nodes[nodeIndex];
+    const glm::mat4 transform = parentTransform * getNodeTransform(node);
+
+    if (node.mesh >= 0)
+        for (const auto& primitive : model.meshes[node.mesh].primitives)
+            appendPrimitive(model, primitive, transform, geometry);
+
+    for (const int child : node.children)
+        appendNode(model, child, transform, geometry);
+}
+
+struct VertexBytesHash
+{
+    size_t operator()(const Vertex& vertex) const
+    {
+        return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(&vertex), sizeof(Vertex)));
+    }
+};
+
+struct VertexBytesEqual
+{
+    bool operator()(const Vertex& a, const Vertex& b) const
+    {
+        return memcmp(&a, &b, sizeof(Vertex)) == 0;
+    }
+};
+
+/** Vertices that are equal bit for bit are merged, exporters split them per primitive and per face more often than not **/
+static void deduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    std::unordered_map<Vertex, uint32_t, VertexBytesHash, VertexBytesEqual> unique;
+    unique.reserve(vertices.size());
+
+    std::vector<Vertex> merged;
+    std::vector<uint32_t> remap(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<uint32_t>(merged.size()));
+        if (inserted)
+            merged.push_back(vertices[i]);
+        remap[i] = it->second;
+    }
+
+    for (auto& index : indices)
+        index = remap[index];
+    vertices.swap(merged);
+}
+
+/** Tipsify: fans out around one vertex at a time and picks the next one among the vertices just emitted that will still be cached
+    after its remaining triangles are drawn. Returns the first triangle of every cluster, a cluster starts wherever the cache went cold **/
+static std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t>& indices, const uint32_t vertexCount)
+{
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return {};
+
+    // the triangles around every vertex, packed into one array
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (const uint32_t index : indices)
+        adjacencyOffsets[index + 1]++;
+    for (uint32_t v = 0; v < vertexCount; v++)
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (uint32_t i = 0; i < indices.size(); i++)
+        adjacency[fill[indices[i]]++] = i / 3;
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+
+    // a vertex is cached while fewer than VERTEX_CACHE_SIZE vertices were pushed after it, starting the clock past the size leaves everything cold
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = VERTEX_CACHE_SIZE + 1;
+    const auto isCached = [&](const uint32_t v) { return time - cacheTime[v] <= VERTEX_CACHE_SIZE; };
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<uint32_t> clusterStarts;
+
+    uint32_t scanCursor = 0;
+    int64_t fan = 0;
+    bool coldStart = true;
+    while (fan >= 0)
+    {
+        if (coldStart && adjacencyOffsets[fan] != adjacencyOffsets[fan + 1])
+            clusterStarts.push_back(static_cast<uint32_t>(output.size() / 3));
+
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; a++)
+        {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[triangle * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (!isCached(v))
+                    cacheTime[v] = time++;
+            }
+        }
+
+        // the candidate that stays cached longest once its own fan is drawn, one that would fall out anyway scores 0
+        fan = -1;
+        int64_t bestPriority = -1;
+        for (const uint32_t v : candidates)
+        {
+            if (liveTriangles[v] == 0) continue;
+
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= VERTEX_CACHE_SIZE)
+                priority = time - cacheTime[v];
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fan = v;
+            }
+        }
+        if (fan >= 0)
+        {
+            coldStart = false;
+            continue;
+        }
+
+        // dead end, back up to the most recent vertex with triangles left, or scan for the next one in input order
+        while (!deadEnd.empty() && fan < 0)
+        {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[v] > 0)
+                fan = v;
+        }
+        for (; fan < 0 && scanCursor < vertexCount; scanCursor++)
+            if (liveTriangles[scanCursor] > 0)
+                fan = scanCursor;
+        coldStart = fan >= 0 && !isCached(static_cast<uint32_t>(fan));
+    }
+
+    indices.swap(output);
+    return clusterStarts;
+}
+
+/** Draws the clusters that face away from the center of the mesh first, they're the ones most likely to occlude the rest.
+    Only reorders whole clusters, so the cache behaviour inside each one is kept **/
+static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::span<const Vertex> vertices, const std::vector<uint32_t>& clusterStarts)
+{
+    if (clusterStarts.size() <= 1)
+        return;
+
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    // everything is area weighted, the cross product is the normal scaled by twice the area which is all the weighting needs
+    const auto triangleCenter = [&](const uint32_t triangle) {
+        return (vertices[indices[triangle * 3]].position + vertices[indices[triangle * 3 + 1]].position + vertices[indices[triangle * 3 + 2]].position) / 3.f;
+    };
+    const auto triangleNormal = [&](const uint32_t triangle) {
+        const glm::vec3 a = vertices[indices[triangle * 3]].position;
+        return glm::cross(vertices[indices[triangle * 3 + 1]].position - a, vertices[indices[triangle * 3 + 2]].position - a);
+    };
+
+    glm::vec3 meshCenter(0.f);
+    float meshArea = 0.f;
+    for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        const float area = glm::length(triangleNormal(triangle));
+        meshCenter += triangleCenter(triangle) * area;
+        meshArea += area;
+    }
+    if (meshArea <= 0.f)
+        return;
+    meshCenter /= meshArea;
+
+    struct Cluster
+    {
+        uint32_t first_triangle;
+        uint32_t triangle_count;
+        float facing;
+    };
+    std::vector<Cluster> clusters;
+    for (size_t c = 0; c < clusterStarts.size(); c++)
+    {
+        const uint32_t first = clusterStarts[c];
+        const uint32_t last = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+
+        glm::vec3 center(0.f);
+        glm::vec3 normal(0.f);
+        float area = 0.f;
+        for (uint32_t triangle = first; triangle < last; triangle++)
+        {
+            const glm::vec3 triangleArea = triangleNormal(triangle);
+            const float length = glm::length(triangleArea);
+            center += triangleCenter(triangle) * length;
+            normal += triangleArea;
+            area += length;
+        }
+
+        float facing = 0.f;
+        if (area > 0.f && glm::length(normal) > 0.f)
+            facing = glm::dot(center / area - meshCenter, glm::normalize(normal));
+        clusters.push_back({.first_triangle = first, .triangle_count = last - first, .facing = facing});
+    }
+
+    std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::facing);
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (const auto& cluster : clusters)
+        sorted.insert(sorted.end(), indices.begin() + cluster.first_triangle * 3, indices.begin() + (cluster.first_triangle + cluster.triangle_count) * 3);
+    indices.swap(sorted);
+}
+
+/** Walks the triangles in order and copies each vertex into the current part on first use, so every part comes out in fetch order.
+    A new part starts once the next triangle might not fit in 16 bit indices **/
+static std::vector<WMeshPart> splitMesh(const std::span<const Vertex> vertices, const std::span<const uint32_t> indices)
+{
+    std::vector<WMeshPart> parts;
+    // the local index is only valid for the part it was stamped with, so the table never has to be cleared
+    std::vector<uint32_t> localIndex(vertices.size());
+    std::vector<uint32_t> stamp(vertices.size(), ~0u);
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (parts.empty() || parts.back().vertices.size() + 3 > WMESH_MAX_PART_VERTICES)
+            parts.emplace_back();
+
+        const auto partIndex = static_cast<uint32_t>(parts.size() - 1);
+        WMeshPart& part = parts.back();
+        for (size_t k = 0; k < 3; k++)
+        {
+            const uint32_t v = indices[i + k];
+            if (stamp[v] != partIndex)
+            {
+                stamp[v] = partIndex;
+                localIndex[v] = static_cast<uint32_t>(part.vertices.size());
+                part.vertices.push_back(vertices[v]);
+            }
+            part.indices.push_back(static_cast<uint16_t>(localIndex[v]));
+        }
+    }
+
+    for (auto& part : parts)
+        part.bounding_sphere = computeBoundingSphere(part.vertices);
+    return parts;
+}
+
+WImportedMesh importGltf(const std::filesystem::path& path)
+{
+    tinygltf::TinyGLTF loader;
+    loader.SetImageLoader(skipImage, nullptr);
+
+    tinygltf::Model model;
+    std::string error;
+    std::string warning;
+    const bool loaded = path.extension() == ".glb"
+        ? loader.LoadBinaryFromFile(&model, &error, &warning, path.string())
+        : loader.LoadASCIIFromFile(&model, &error, &warning, path.string());
+    if (!warning.empty())
+        std::cerr << warning << std::endl;
+    if (!loaded)
+        WRenderer::WThrowException("failed to load " + path.string() + ": " + error);
+
+    ImportGeometry geometry;
+    if (model.scenes.empty())
+    {
+        // files without a scene still list their meshes, they're taken as they are
+        for (const auto& gltfMesh : model.meshes)
+            for (const auto& primitive : gltfMesh.primitives)
+                appendPrimitive(model, primitive, glm::mat4(1.f), geometry);
+    }
+    else
+    {
+        const tinygltf::Scene& scene = model.scenes[std::max(model.defaultScene, 0)];
+        for (const int node : scene.nodes)
+            appendNode(model, node, glm::mat4(1.f), geometry);
+    }
+
+    if (geometry.vertices.empty() || geometry.indices.empty())
+        WRenderer::WThrowException(path.string() + " has no triangles");
+    return optimizeMesh(geometry.vertices, geometry.indices);
+}
+
+WImportedMesh optimizeMesh(const std::span<const Vertex> vertices, const std::span<const uint32_t> indices)
+{
+    if (std::ranges::any_of(indices, [&](const uint32_t index) { return index >= vertices.size(); }))
+        WRenderer::WThrowException("mesh index out of range");
+
+    std::vector<Vertex> uniqueVertices(vertices.begin(), vertices.end());
+    std::vector<uint32_t> optimizedIndices(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+    deduplicateVertices(uniqueVertices, optimizedIndices);
+
+    const std::vector<uint32_t> clusterStarts = optimizeVertexCache(optimizedIndices, static_cast<uint32_t>(uniqueVertices.size()));
+    optimizeOverdraw(optimizedIndices, uniqueVertices, clusterStarts);
+
+    return {
+        .parts = splitMesh(uniqueVertices, optimizedIndices),
+        .source_vertex_count = static_cast<uint32_t>(vertices.size())
+    };
+}
+
+glm::vec4 computeBoundingSphere(const std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+        return glm::vec4(0.f);
+
+    glm::vec3 boundsMin = vertices.front().position;
+    glm::vec3 boundsMax = boundsMin;
+    for (const auto& vertex : vertices)
+    {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    float radius = 0.f;
+    for (const auto& vertex : vertices)
+        radius = std::max(radius, glm::length(vertex.position - center));
+    return glm::vec4(center, radius);
+}
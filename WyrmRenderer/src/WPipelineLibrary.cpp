@@ -0,0 +1,310 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WPipelineLibrary.h"
+
+#include <algorithm>
+#include <iostream>
+
+template<typename T>
+static void hashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+size_t WGraphicsPipelineState::Hash() const
+{
+    size_t seed = 0;
+    hashCombine(seed, shader);
+    hashCombine(seed, vertex_layout.stride);
+    for (uint32_t i = 0; i < vertex_layout.attribute_count; i++)
+    {
+        const auto& attribute = vertex_layout.attributes[i];
+        hashCombine(seed, attribute.location);
+        hashCombine(seed, attribute.binding);
+        hashCombine(seed, attribute.format);
+        hashCombine(seed, attribute.offset);
+    }
+    hashCombine(seed, topology);
+    hashCombine(seed, polygon_mode);
+    hashCombine(seed, static_cast<VkCullModeFlags>(cull_mode));
+    hashCombine(seed, front_face);
+    hashCombine(seed, blend_enable);
+    hashCombine(seed, src_blend_factor);
+    hashCombine(seed, dst_blend_factor);
+    hashCombine(seed, depth_test);
+    hashCombine(seed, depth_write);
+    hashCombine(seed, depth_compare);
+    hashCombine(seed, color_format);
+    hashCombine(seed, depth_format);
+    return seed;
+}
+
+WPipelineLibrary::~WPipelineLibrary()
+{
+    Destroy();
+}
+
+void WPipelineLibrary::Init(const vk::raii::Device& _device, const vk::raii::PipelineCache& _pipelineCache, const vk::PipelineLayout _layout, const uint32_t workerCount)
+{
+    device = &_device;
+    pipeline_cache = &_pipelineCache;
+    layout = _layout;
+
+    stopping = false;
+    for (uint32_t i = 0; i < std::max(workerCount, 1u); i++)
+        workers.emplace_back(&WPipelineLibrary::worker_loop, this);
+}
+
+void WPipelineLibrary::Destroy()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+
+    finished.clear();
+    pending.clear();
+    failed.clear();
+    pipelines.clear();
+    shaders.clear();
+}
+
+WShaderId WPipelineLibrary::AddShader(const std::span<const uint32_t> spirv, std::string vertexEntry, std::string fragmentEntry)
+{
+    const vk::ShaderModuleCreateInfo shaderModuleCI {
+        .codeSize = spirv.size_bytes(),
+        .pCode = spirv.data()
+    };
+    shaders.push_back({
+        .module = std::make_shared<const vk::raii::ShaderModule>(*device, shaderModuleCI),
+        .vertex_entry = std::move(vertexEntry),
+        .fragment_entry = std::move(fragmentEntry)
+    });
+    return static_cast<WShaderId>(shaders.size() - 1);
+}
+
+std::vector<vk::raii::Pipeline> WPipelineLibrary::ReplaceShader(const WShaderId shader, const std::span<const uint32_t> spirv)
+{
+    const vk::ShaderModuleCreateInfo shaderModuleCI {
+        .codeSize = spirv.size_bytes(),
+        .pCode = spirv.data()
+    };
+    shaders[shader].module = std::make_shared<const vk::raii::ShaderModule>(*device, shaderModuleCI);
+    // results of compiles that already started carry the old generation and are thrown away
+    shaders[shader].generation++;
+
+    {
+        std::lock_guard lock(mutex);
+        std::erase_if(jobs, [&](const auto& job) { return job.first.shader == shader; });
+    }
+    std::erase_if(pending, [&](const WGraphicsPipelineState& state) { return state.shader == shader; });
+    std::erase_if(failed, [&](const WGraphicsPipelineState& state) { return state.shader == shader; });
+
+    std::vector<vk::raii::Pipeline> dropped;
+    for (auto it = pipelines.begin(); it != pipelines.end();)
+    {
+        if (it->first.shader == shader)
+        {
+            dropped.push_back(std::move(it->second));
+            it = pipelines.erase(it);
+        }
+        else
+            ++it;
+    }
+    return dropped;
+}
+
+vk::raii::Pipeline WPipelineLibrary::Build(const WGraphicsPipelineState& state) const
+{
+    return build(state, shaders[state.shader]);
+}
+
+vk::Pipeline WPipelineLibrary::Find(const WGraphicsPipelineState& state)
+{
+    if (const auto it = pipelines.find(state); it != pipelines.end())
+        return it->second;
+
+    if (!failed.contains(state) && pending.insert(state).second)
+    {
+        {
+            std::lock_guard lock(mutex);
+            jobs.emplace_back(state, shaders[state.shader]);
+        }
+        wake.notify_one();
+    }
+    return nullptr;
+}
+
+bool WPipelineLibrary::CollectFinished()
+{
+    std::vector<CompileResult> results;
+    {
+        std::lock_guard lock(mutex);
+        results.swap(finished);
+    }
+
+    bool anyReady = false;
+    for (auto& result : results)
+    {
+        if (result.generation != shaders[result.state.shader].generation)
+            continue;
+
+        pending.erase(result.state);
+        // failed states fall back for good instead of failing again every frame
+        if (!*result.pipeline)
+        {
+            failed.insert(result.state);
+            continue;
+        }
+
+        pipelines.emplace(result.state, std::move(result.pipeline));
+        anyReady = true;
+    }
+    return anyReady;
+}
+
+uint32_t WPipelineLibrary::GetPendingCount() const
+{
+    return static_cast<uint32_t>(pending.size());
+}
+
+void WPipelineLibrary::worker_loop()
+{
+    while (true)
+    {
+        std::pair<WGraphicsPipelineState, Shader> job;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        CompileResult result {.state = job.first, .generation = job.second.generation};
+        try
+        {
+            result.pipeline = build(job.first, job.second);
+        }
+        catch (const vk::SystemError& e)
+        {
+            std::cerr << "failed to compile pipeline " << std::hex << job.first.Hash() << std::dec << ": " << e.what() << std::endl;
+        }
+
+        std::lock_guard lock(mutex);
+        finished.push_back(std::move(result));
+    }
+}
+
+vk::raii::Pipeline WPipelineLibrary::build(const WGraphicsPipelineState& state, const Shader& shader) const
+{
+    const vk::PipelineShaderStageCreateInfo shaderStages[] = {
+        {
+            .stage = vk::ShaderStageFlagBits::eVertex,
+            .module = *shader.module,
+            .pName = shader.vertex_entry.c_str()
+        },
+        {
+            .stage = vk::ShaderStageFlagBits::eFragment,
+            .module = *shader.module,
+            .pName = shader.fragment_entry.c_str()
+        }
+    };
+
+    const vk::VertexInputBindingDescription vertexBindingDescription {
+        .binding = 0,
+        .stride = state.vertex_layout.stride,
+        .inputRate = vk::VertexInputRate::eVertex
+    };
+    const vk::PipelineVertexInputStateCreateInfo vertexInputCI {
+        .vertexBindingDescriptionCount = 1,
+        .pVertexBindingDescriptions = &vertexBindingDescription,
+        .vertexAttributeDescriptionCount = state.vertex_layout.attribute_count,
+        .pVertexAttributeDescriptions = state.vertex_layout.attributes.data(),
+    };
+    const vk::PipelineInputAssemblyStateCreateInfo inputAssemblyCI {
+        .topology = state.topology
+    };
+
+    constexpr std::array dynamicStates = {
+        vk::DynamicState::eViewport,
+        vk::DynamicState::eScissor
+    };
+    const vk::PipelineDynamicStateCreateInfo dynamicStateCI {
+        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+        .pDynamicStates = dynamicStates.data()
+    };
+
+    constexpr vk::PipelineViewportStateCreateInfo viewPortCI {
+        .viewportCount = 1,
+        .scissorCount = 1
+    };
+    const vk::PipelineRasterizationStateCreateInfo rasterizerCI {
+        .depthClampEnable = vk::False,
+        .rasterizerDiscardEnable = vk::False,
+        .polygonMode = state.polygon_mode,
+        .cullMode = state.cull_mode,
+        .frontFace = state.front_face,
+        .depthBiasEnable = vk::False,
+        .lineWidth = 1.0f
+    };
+    constexpr vk::PipelineMultisampleStateCreateInfo multisamplingCI {
+        .rasterizationSamples = vk::SampleCountFlagBits::e1,
+        .sampleShadingEnable = vk::False
+    };
+    const vk::PipelineDepthStencilStateCreateInfo depthStencilCI {
+        .depthTestEnable = state.depth_test,
+        .depthWriteEnable = state.depth_write,
+        .depthCompareOp = state.depth_compare,
+        .depthBoundsTestEnable = vk::False,
+        .stencilTestEnable = vk::False
+    };
+    const vk::PipelineColorBlendAttachmentState colorBlendAttachment {
+        .blendEnable = state.blend_enable,
+        .srcColorBlendFactor = state.src_blend_factor,
+        .dstColorBlendFactor = state.dst_blend_factor,
+        .colorBlendOp = vk::BlendOp::eAdd,
+        .srcAlphaBlendFactor = vk::BlendFactor::eOne,
+        .dstAlphaBlendFactor = vk::BlendFactor::eZero,
+        .alphaBlendOp = vk::BlendOp::eAdd,
+        .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
+    };
+    const vk::PipelineColorBlendStateCreateInfo colorBlendingCI {
+        .logicOpEnable = vk::False,
+        .attachmentCount = 1,
+        .pAttachments = &colorBlendAttachment
+    };
+
+    const vk::PipelineRenderingCreateInfo pipelineRenderingCI {
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &state.color_format,
+        .depthAttachmentFormat = state.depth_format
+    };
+    const vk::GraphicsPipelineCreateInfo pipelineCI {
+        .pNext = &pipelineRenderingCI,
+        .stageCount = 2,
+        .pStages = shaderStages,
+        .pVertexInputState = &vertexInputCI,
+        .pInputAssemblyState = &inputAssemblyCI,
+        .pViewportState = &viewPortCI,
+        .pRasterizationState = &rasterizerCI,
+        .pMultisampleState = &multisamplingCI,
+        .pDepthStencilState = state.depth_format != vk::Format::eUndefined ? &depthStencilCI : nullptr,
+        .pColorBlendState = &colorBlendingCI,
+        .pDynamicState = &dynamicStateCI,
+        .layout = layout,
+        .renderPass = nullptr
+    };
+
+    // the cache synchronizes itself, so the workers can share it
+    return {*device, *pipeline_cache, pipelineCI};
+}
@@ -0,0 +1,306 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+void WProfiler::Init(const vk::raii::Device& _device, const vk::raii::PhysicalDevice& physicalDevice, const uint32_t queueFamilyIndex, const uint32_t framesInFlight)
+{
+    device = *_device;
+
+    const auto timestampValidBits = physicalDevice.getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits;
+    timestamp_period = physicalDevice.getProperties().limits.timestampPeriod;
+    gpu_timing_supported = timestampValidBits > 0 && timestamp_period > 0.f;
+    timestamp_mask = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+
+    frame_queries.clear();
+    frame_queries.resize(framesInFlight);
+    if (!gpu_timing_supported) return;
+
+    constexpr vk::QueryPoolCreateInfo queryPoolCI {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = WFrameTimings::MAX_GPU_SCOPES * 2
+    };
+    for (auto& frame : frame_queries)
+        frame.pool = {_device, queryPoolCI};
+}
+
+void WProfiler::Destroy()
+{
+    frame_queries.clear();
+    device = VK_NULL_HANDLE;
+}
+
+void WProfiler::SetEnabled(const bool _enabled)
+{
+    enabled = _enabled;
+}
+
+bool WProfiler::IsEnabled() const
+{
+    return enabled;
+}
+
+void WProfiler::BeginFrame(const uint32_t frameIndex)
+{
+    current_slot = frameIndex;
+    if (!enabled) return;
+
+    current = {};
+    current.frame_number = frame_number++;
+    open_scope_count = 0;
+    frame_start = Clock::now();
+}
+
+void WProfiler::ResolveFrame(const uint32_t frameIndex)
+{
+    if (frameIndex >= frame_queries.size()) return;
+
+    auto& frame = frame_queries[frameIndex];
+    if (!frame.has_pending) return;
+    frame.has_pending = false;
+
+    if (frame.query_count > 0)
+    {
+        // the timeline value of this slot has been reached, so the results are available and this never blocks
+        std::array<uint64_t, WFrameTimings::MAX_GPU_SCOPES * 2> timestamps {};
+        const auto result = vkGetQueryPoolResults(
+            device,
+            *frame.pool,
+            0,
+            frame.query_count,
+            frame.query_count * sizeof(uint64_t),
+            timestamps.data(),
+            sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT
+        );
+
+        if (result == VK_SUCCESS)
+        {
+            uint64_t first = ~0ull, last = 0;
+            const uint32_t scopeCount = frame.query_count / 2;
+            for (uint32_t i = 0; i < scopeCount; i++)
+            {
+                const uint64_t begin = timestamps[i * 2] & timestamp_mask;
+                const uint64_t end = timestamps[i * 2 + 1] & timestamp_mask;
+                first = std::min(first, begin);
+                last = std::max(last, end);
+
+                frame.pending.gpu_scopes[i] = {
+                    .name = frame.scope_names[i],
+                    .milliseconds = static_cast<float>(static_cast<double>(end - begin) * timestamp_period * 1e-6)
+                };
+            }
+            frame.pending.gpu_scope_count = scopeCount;
+            frame.pending.gpu_frame_ms = last > first ? static_cast<float>(static_cast<double>(last - first) * timestamp_period * 1e-6) : 0.f;
+        }
+    }
+    // a frame that ends without recording anything must not pick up these queries again
+    frame.query_count = 0;
+
+    publish(frame.pending);
+}
+
+void WProfiler::EndFrame()
+{
+    if (!enabled) return;
+
+    current.cpu_frame_ms = std::chrono::duration<float, std::milli>(Clock::now() - frame_start).count();
+
+    if (!gpu_timing_supported || current_slot >= frame_queries.size())
+    {
+        publish(current);
+        return;
+    }
+
+    // the gpu half is filled in by ResolveFrame once this slot comes around again
+    auto& frame = frame_queries[current_slot];
+    frame.pending = current;
+    frame.has_pending = true;
+}
+
+uint32_t WProfiler::BeginCpuZone(const char* name)
+{
+    if (!enabled || current.cpu_zone_count >= WFrameTimings::MAX_CPU_ZONES)
+        return WFrameTimings::MAX_CPU_ZONES;
+
+    const uint32_t zone = current.cpu_zone_count++;
+    current.cpu_zones[zone].name = name;
+    zone_starts[zone] = Clock::now();
+    return zone;
+}
+
+void WProfiler::EndCpuZone(const uint32_t zone)
+{
+    if (!enabled || zone >= current.cpu_zone_count) return;
+
+    current.cpu_zones[zone].milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - zone_starts[zone]).count();
+}
+
+void WProfiler::CmdResetQueries(const vk::raii::CommandBuffer& commandBuffer)
+{
+    if (!enabled || !gpu_timing_supported) return;
+
+    auto& frame = frame_queries[current_slot];
+    frame.query_count = 0;
+    commandBuffer.resetQueryPool(*frame.pool, 0, WFrameTimings::MAX_GPU_SCOPES * 2);
+}
+
+void WProfiler::CmdBeginScope(const vk::raii::CommandBuffer& commandBuffer, const char* name)
+{
+    if (!enabled || !gpu_timing_supported || open_scope_count >= open_scopes.size()) return;
+
+    auto& frame = frame_queries[current_slot];
+    const uint32_t scope = frame.query_count / 2;
+    if (scope >= WFrameTimings::MAX_GPU_SCOPES)
+    {
+        // keeps begin/end pairs balanced, the overflowing scope is just not timed
+        open_scopes[open_scope_count++] = WFrameTimings::MAX_GPU_SCOPES;
+        return;
+    }
+
+    frame.scope_names[scope] = name;
+    frame.query_count += 2;
+    open_scopes[open_scope_count++] = scope;
+    commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *frame.pool, scope * 2);
+}
+
+void WProfiler::CmdEndScope(const vk::raii::CommandBuffer& commandBuffer)
+{
+    if (!enabled || !gpu_timing_supported || open_scope_count == 0) return;
+
+    const uint32_t scope = open_scopes[--open_scope_count];
+    if (scope >= WFrameTimings::MAX_GPU_SCOPES) return;
+
+    commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *frame_queries[current_slot].pool, scope * 2 + 1);
+}
+
+uint64_t WProfiler::GetNextFrameNumber() const
+{
+    return frame_number;
+}
+
+uint64_t WProfiler::GetPublishedFrameCount() const
+{
+    return published.load(std::memory_order_acquire);
+}
+
+bool WProfiler::GetFrame(const uint64_t frameNumber, WFrameTimings& timings) const
+{
+    if (frameNumber >= published.load(std::memory_order_acquire)) return false;
+
+    const auto& slot = ring[frameNumber % RING_SIZE];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != frameNumber * 2 + 2) return false;
+
+    timings = slot.timings;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool WProfiler::GetLatestFrame(WFrameTimings& timings) const
+{
+    const uint64_t count = published.load(std::memory_order_acquire);
+    return count > 0 && GetFrame(count - 1, timings);
+}
+
+WTimingSummary WProfiler::SummarizeCpuFrame(const uint32_t window) const
+{
+    return summarize(window, [](const WFrameTimings& timings) { return timings.cpu_frame_ms; });
+}
+
+WTimingSummary WProfiler::SummarizeGpuFrame(const uint32_t window) const
+{
+    return summarize(window, [](const WFrameTimings& timings) { return timings.gpu_scope_count > 0 ? timings.gpu_frame_ms : -1.f; });
+}
+
+WTimingSummary WProfiler::SummarizeCpuZone(const char* name, const uint32_t window) const
+{
+    return summarize(window, [name](const WFrameTimings& timings) {
+        float total = -1.f;
+        for (uint32_t i = 0; i < timings.cpu_zone_count; i++)
+            if (timings.cpu_zones[i].name == name || strcmp(timings.cpu_zones[i].name, name) == 0)
+                total = std::max(total, 0.f) + timings.cpu_zones[i].milliseconds;
+        return total;
+    });
+}
+
+WTimingSummary WProfiler::SummarizeGpuScope(const char* name, const uint32_t window) const
+{
+    return summarize(window, [name](const WFrameTimings& timings) {
+        float total = -1.f;
+        for (uint32_t i = 0; i < timings.gpu_scope_count; i++)
+            if (timings.gpu_scopes[i].name == name || strcmp(timings.gpu_scopes[i].name, name) == 0)
+                total = std::max(total, 0.f) + timings.gpu_scopes[i].milliseconds;
+        return total;
+    });
+}
+
+void WProfiler::publish(const WFrameTimings& timings)
+{
+    // single writer seqlock, an odd sequence tells readers that the slot is being overwritten
+    const uint64_t frame = published.load(std::memory_order_relaxed);
+    auto& slot = ring[frame % RING_SIZE];
+
+    slot.sequence.store(frame * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timings = timings;
+    slot.sequence.store(frame * 2 + 2, std::memory_order_release);
+
+    published.store(frame + 1, std::memory_order_release);
+}
+
+template<typename Sample>
+WTimingSummary WProfiler::summarize(const uint32_t window, Sample sample) const
+{
+    std::array<float, RING_SIZE> samples {};
+    uint32_t sampleCount = 0;
+
+    const uint64_t count = published.load(std::memory_order_acquire);
+    const uint64_t span = std::min<uint64_t>({window, count, RING_SIZE - 1});
+
+    WFrameTimings timings;
+    for (uint64_t frame = count - span; frame < count; frame++)
+    {
+        const auto& slot = ring[frame % RING_SIZE];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != frame * 2 + 2) continue;
+
+        timings = slot.timings;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+        if (const float value = sample(timings); value >= 0.f)
+            samples[sampleCount++] = value;
+    }
+
+    WTimingSummary summary {.sample_count = sampleCount};
+    if (sampleCount == 0) return summary;
+
+    const auto end = samples.begin() + sampleCount;
+    float total = 0.f;
+    for (auto it = samples.begin(); it != end; ++it)
+        total += *it;
+
+    const auto [minIt, maxIt] = std::minmax_element(samples.begin(), end);
+    summary.min_ms = *minIt;
+    summary.max_ms = *maxIt;
+    summary.avg_ms = total / static_cast<float>(sampleCount);
+
+    const auto p99It = samples.begin() + std::min<uint32_t>(sampleCount - 1, sampleCount * 99 / 100);
+    std::nth_element(samples.begin(), p99It, end);
+    summary.p99_ms = *p99It;
+    return summary;
+}
+
+WCpuZone::WCpuZone(WProfiler& _profiler, const char* name) : profiler(_profiler), zone(_profiler.BeginCpuZone(name))
+{}
+
+WCpuZone::~WCpuZone()
+{
+    profiler.EndCpuZone(zone);
+}
@@ -3,19 +3,28 @@
 //
 
 #include "WRenderer.h"
+#include "WMappedFile.h"
+#include "WMeshFormat.h"
+#include "WMeshImport.h"
 
 #define VMA_IMPLEMENTATION
 #define VMA_STATIC_VULKAN_FUNCTIONS 0
 #define VMA_DYNAMIC_VULKAN_FUNCTIONS 1
 #include "vk_mem_alloc.h"
 
+// generated by wyrm_embed_shader
+#include "shaders/shader_spirv.h"
+#include "shaders/cull_spirv.h"
+
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
-
-void create_buffer(const VmaAllocator& _allocator, vk::DeviceSize size, vk::BufferUsageFlags usage, VmaMemoryUsage memoryUsage, vk::Buffer& buffer, VmaAllocation& allocation);
+#include <tuple>
+#include <utility>
 
 WRenderer& WRenderer::GetInstance()
 {
@@ -28,14 +37,86 @@ GLFWwindow* WRenderer::GetWindow() const
     return window;
 }
 
+WProfiler& WRenderer::GetProfiler()
+{
+    return profiler;
+}
+
 void WRenderer::SetWindowSize(const int _width, const int _height)
 {
     width = _width;
     height = _height;
+
+    // there is no window to report the resize in headless mode, so the offscreen targets are rebuilt on the next frame
+    if (headless && *device)
+        frame_buffer_resized = true;
+}
+
+void WRenderer::SetHeadless(const bool _headless)
+{
+    headless = _headless;
+}
+
+bool WRenderer::IsHeadless() const
+{
+    return headless;
+}
+
+void WRenderer::SetPipelineCachePath(const std::filesystem::path& path)
+{
+    pipeline_cache_path = path;
+}
+
+void WRenderer::SetGeometryPoolCapacity(const uint32_t vertexCount, const uint32_t indexCount)
+{
+    geometry_vertex_capacity = vertexCount;
+    geometry_index_capacity = indexCount;
+}
+
+void WRenderer::SetGpuCulling(const bool enabled)
+{
+    gpu_culling = enabled;
+}
+
+bool WRenderer::IsGpuCulling() const
+{
+    return gpu_culling;
+}
+
+void WRenderer::SetRecordThreadCount(const uint32_t count)
+{
+    record_thread_count = std::max(count, 1u);
+}
+
+void WRenderer::SetParallelFor(WParallelFor parallelFor)
+{
+    parallel_for = std::move(parallelFor);
+}
+
+void WRenderer::SetFramesInFlight(const uint32_t count)
+{
+    if (count == 0 || count > MAX_FRAMES_IN_FLIGHT)
+        WThrowException("frames in flight has to be between 1 and " + std::to_string(MAX_FRAMES_IN_FLIGHT));
+    if (*device)
+        WThrowException("frames in flight can only be changed before InitVulkan");
+
+    frames_in_flight = count;
+}
+
+uint32_t WRenderer::GetFramesInFlight() const
+{
+    return frames_in_flight;
+}
+
+void WRenderer::SetPendingPipelinePolicy(const WPendingPipelinePolicy policy)
+{
+    pending_pipeline_policy = policy;
 }
 
 void WRenderer::InitWindow()
 {
+    if (headless) return;
+
     glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -43,103 +124,816 @@ void WRenderer::InitWindow()
     window = glfwCreateWindow(static_cast<int>(width), static_cast<int>(height), "Vulkan", nullptr, nullptr);
     glfwSetWindowUserPointer(window, this);
     glfwSetFramebufferSizeCallback(window, frame_buffer_resize_callback);
+    window_thread = std::this_thread::get_id();
+
+    int framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    framebuffer_width = framebufferWidth;
+    framebuffer_height = framebufferHeight;
 }
 
 void WRenderer::InitVulkan()
 {
+    if (!headless)
+        device_extensions.push_back(vk::KHRSwapchainExtensionName);
+
     create_vulkan_instance();
     setup_debug_messenger();
-    create_surface();
+    if (!headless)
+        create_surface();
     pick_physical_device();
     create_logical_device();
     vma_init();
-    create_swap_chain();
+    allocation_tracker.Init(allocator);
+    residency_manager.Init(allocator, physical_device);
+    profiler.Init(device, physical_device, queue_index, frames_in_flight);
+    upload_manager.Init(device, allocator, allocation_tracker, transfer_queue_index);
+    geometry_pool.Init(allocator, allocation_tracker, sizeof(Vertex), geometry_vertex_capacity, geometry_index_capacity, buffer_queue_families);
+    if (headless)
+        create_offscreen_images();
+    else
+        create_swap_chain();
     create_image_views();
     create_descriptor_set_layout();
+    bindless_heap.Init(device, physical_device);
+    create_default_sampler();
+    create_pipeline_cache();
     create_graphics_pipeline();
+    create_cull_pipeline();
+    start_shader_hot_reload();
     create_command_pool();
-    create_vertex_buffer();
-    create_index_buffer();
-    create_uniform_buffers();
+    frame_allocator.Init(
+        allocator,
+        allocation_tracker,
+        device,
+        physical_device,
+        vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        frames_in_flight
+    );
     create_descriptor_pool();
     create_descriptor_sets();
     create_command_buffers();
+    create_record_slots();
     create_sync_object();
 }
 
+std::string WRenderer::GetDeviceName() const
+{
+    return physical_device.getProperties().deviceName;
+}
+
+void WRenderer::WaitIdle()
+{
+    device.waitIdle();
+    deletion_queue.Flush();
+}
+
+vk::Semaphore WRenderer::GetFrameTimelineSemaphore() const
+{
+    return *frame_timeline;
+}
+
+uint64_t WRenderer::GetSubmittedFrameValue() const
+{
+    return frame_timeline_value;
+}
+
+uint64_t WRenderer::GetCompletedFrameValue() const
+{
+    return frame_timeline.getCounterValue();
+}
+
+void WRenderer::WaitForFrameValue(const uint64_t value) const
+{
+    if (value == 0) return;
+
+    const vk::SemaphoreWaitInfo waitI {
+        .semaphoreCount = 1,
+        .pSemaphores = &*frame_timeline,
+        .pValues = &value
+    };
+    if (device.waitSemaphores(waitI, UINT64_MAX) != vk::Result::eSuccess)
+        WThrowException("failed to wait for the frame timeline");
+}
+
+WBufferHandle WRenderer::CreateBuffer(const vk::DeviceSize size, const vk::BufferUsageFlags usage, const bool hostVisible, const WAllocationCategory category, const std::string_view debugName)
+{
+    // shared with the transfer queue like the geometry, so uploads can write into it directly
+    const vk::BufferCreateInfo bufferCI {
+        .size = size,
+        .usage = usage,
+        .sharingMode = buffer_queue_families.size() > 1 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = buffer_queue_families.size() > 1 ? static_cast<uint32_t>(buffer_queue_families.size()) : 0u,
+        .pQueueFamilyIndices = buffer_queue_families.size() > 1 ? buffer_queue_families.data() : nullptr
+    };
+    const VmaAllocationCreateInfo allocationCI {
+        .flags = hostVisible ? VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT : 0u,
+        .usage = VMA_MEMORY_USAGE_AUTO
+    };
+
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    VmaAllocationInfo allocationInfo;
+    if (const VkResult result = vmaCreateBuffer(allocator, &*bufferCI, &allocationCI, &buffer, &allocation, &allocationInfo); result != VK_SUCCESS)
+        WThrowException("failed to create buffer " + std::string(debugName) + ": " + vk::to_string(static_cast<vk::Result>(result)));
+    allocation_tracker.Track(allocation, category, debugName);
+
+    const vk::DeviceAddress address = usage & vk::BufferUsageFlagBits::eShaderDeviceAddress
+        ? device.getBufferAddress({.buffer = buffer})
+        : 0;
+
+    const WBufferHandle handle = buffer_pool.Allocate(buffer, allocation, allocationInfo.pMappedData, address);
+    if (!handle)
+    {
+        allocation_tracker.DestroyBuffer(buffer, allocation);
+        WThrowException("out of buffer handles");
+    }
+    return handle;
+}
+
+void WRenderer::DestroyBuffer(const WBufferHandle buffer)
+{
+    if (!buffer_pool.IsValid(buffer))
+        WThrowException("invalid or destroyed buffer handle");
+
+    deletion_queue.Push(frame_timeline_value + 1, [this, vkBuffer = buffer_pool.Get<BUFFER_HANDLE>(buffer), allocation = buffer_pool.Get<BUFFER_ALLOCATION>(buffer)] {
+        allocation_tracker.DestroyBuffer(vkBuffer, allocation);
+    });
+    buffer_pool.Free(buffer);
+}
+
+bool WRenderer::IsValid(const WBufferHandle buffer) const
+{
+    return buffer_pool.IsValid(buffer);
+}
+
+vk::Buffer WRenderer::GetBuffer(const WBufferHandle buffer) const
+{
+    if (!buffer_pool.IsValid(buffer))
+        WThrowException("invalid or destroyed buffer handle");
+    return buffer_pool.Get<BUFFER_HANDLE>(buffer);
+}
+
+vk::DeviceAddress WRenderer::GetBufferAddress(const WBufferHandle buffer) const
+{
+    if (!buffer_pool.IsValid(buffer))
+        WThrowException("invalid or destroyed buffer handle");
+    return buffer_pool.Get<BUFFER_ADDRESS>(buffer);
+}
+
+void* WRenderer::GetBufferMapped(const WBufferHandle buffer) const
+{
+    if (!buffer_pool.IsValid(buffer))
+        WThrowException("invalid or destroyed buffer handle");
+    return buffer_pool.Get<BUFFER_MAPPED>(buffer);
+}
+
+WImageHandle WRenderer::CreateImage(const vk::ImageCreateInfo& imageCI, const WAllocationCategory category, const std::string_view debugName)
+{
+    constexpr VmaAllocationCreateInfo allocationCI {
+        .usage = VMA_MEMORY_USAGE_AUTO
+    };
+
+    VkImage image;
+    VmaAllocation allocation;
+    if (const VkResult result = vmaCreateImage(allocator, &*imageCI, &allocationCI, &image, &allocation, nullptr); result != VK_SUCCESS)
+        WThrowException("failed to create image " + std::string(debugName) + ": " + vk::to_string(static_cast<vk::Result>(result)));
+    allocation_tracker.Track(allocation, category, debugName);
+
+    const bool isDepth =
+        imageCI.format == vk::Format::eD16Unorm ||
+        imageCI.format == vk::Format::eD32Sfloat ||
+        imageCI.format == vk::Format::eD24UnormS8Uint ||
+        imageCI.format == vk::Format::eD32SfloatS8Uint;
+    const bool isCube = static_cast<bool>(imageCI.flags & vk::ImageCreateFlagBits::eCubeCompatible) && imageCI.arrayLayers % 6 == 0;
+
+    vk::ImageViewType viewType = imageCI.arrayLayers > 1 ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D;
+    if (imageCI.imageType == vk::ImageType::e3D)
+        viewType = vk::ImageViewType::e3D;
+    else if (isCube)
+        viewType = imageCI.arrayLayers > 6 ? vk::ImageViewType::eCubeArray : vk::ImageViewType::eCube;
+
+    const vk::ImageViewCreateInfo imageViewCI {
+        .image = image,
+        .viewType = viewType,
+        .format = imageCI.format,
+        .subresourceRange = {isDepth ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor, 0, imageCI.mipLevels, 0, imageCI.arrayLayers}
+    };
+    vk::raii::ImageView view(device, imageViewCI);
+
+    const WImageHandle handle = image_pool.Allocate(image, allocation, view.release());
+    if (!handle)
+    {
+        allocation_tracker.DestroyImage(image, allocation);
+        WThrowException("out of image handles");
+    }
+    return handle;
+}
+
+void WRenderer::DestroyImage(const WImageHandle image)
+{
+    if (!image_pool.IsValid(image))
+        WThrowException("invalid or destroyed image handle");
+
+    deletion_queue.Release(frame_timeline_value + 1, vk::raii::ImageView(device, image_pool.Get<IMAGE_VIEW>(image)));
+    deletion_queue.Push(frame_timeline_value + 1, [this, vkImage = image_pool.Get<IMAGE_HANDLE>(image), allocation = image_pool.Get<IMAGE_ALLOCATION>(image)] {
+        allocation_tracker.DestroyImage(vkImage, allocation);
+    });
+    image_pool.Free(image);
+}
+
+bool WRenderer::IsValid(const WImageHandle image) const
+{
+    return image_pool.IsValid(image);
+}
+
+vk::Image WRenderer::GetImage(const WImageHandle image) const
+{
+    if (!image_pool.IsValid(image))
+        WThrowException("invalid or destroyed image handle");
+    return image_pool.Get<IMAGE_HANDLE>(image);
+}
+
+vk::ImageView WRenderer::GetImageView(const WImageHandle image) const
+{
+    if (!image_pool.IsValid(image))
+        WThrowException("invalid or destroyed image handle");
+    return image_pool.Get<IMAGE_VIEW>(image);
+}
+
+WBindlessIndex WRenderer::RegisterBuffer(const vk::Buffer buffer, const vk::DeviceSize offset, const vk::DeviceSize range)
+{
+    return bindless_heap.RegisterBuffer(buffer, offset, range);
+}
+
+WBindlessIndex WRenderer::RegisterImage(const vk::ImageView view, const vk::ImageLayout layout)
+{
+    return bindless_heap.RegisterImage(view, layout);
+}
+
+WBindlessIndex WRenderer::RegisterSampler(const vk::Sampler sampler)
+{
+    return bindless_heap.RegisterSampler(sampler);
+}
+
+void WRenderer::UnregisterBuffer(const WBindlessIndex index)
+{
+    deletion_queue.Push(frame_timeline_value + 1, [this, index] { bindless_heap.FreeBuffer(index); });
+}
+
+void WRenderer::UnregisterImage(const WBindlessIndex index)
+{
+    deletion_queue.Push(frame_timeline_value + 1, [this, index] { bindless_heap.FreeImage(index); });
+}
+
+void WRenderer::UnregisterSampler(const WBindlessIndex index)
+{
+    deletion_queue.Push(frame_timeline_value + 1, [this, index] { bindless_heap.FreeSampler(index); });
+}
+
+uint64_t WRenderer::FlushUploads()
+{
+    return upload_manager.Flush();
+}
+
+void WRenderer::WaitForUploads(const uint64_t value) const
+{
+    upload_manager.WaitForValue(value);
+}
+
+WMeshHandle WRenderer::CreateMesh(const std::span<const Vertex> meshVertices, const std::span<const uint32_t> meshIndices)
+{
+    if (meshVertices.empty() || meshIndices.empty())
+        WThrowException("can't create a mesh without geometry");
+
+    return create_mesh(meshVertices.data(), static_cast<uint32_t>(meshVertices.size()), meshIndices.data(), static_cast<uint32_t>(meshIndices.size()), vk::IndexType::eUint32, computeBoundingSphere(meshVertices));
+}
+
+WMeshHandle WRenderer::CreateMesh(const std::span<const Vertex> meshVertices, const std::span<const uint16_t> meshIndices)
+{
+    if (meshVertices.empty() || meshIndices.empty())
+        WThrowException("can't create a mesh without geometry");
+    if (meshVertices.size() > WMESH_MAX_PART_VERTICES)
+        WThrowException("a mesh with 16 bit indices can't have more than " + std::to_string(WMESH_MAX_PART_VERTICES) + " vertices");
+
+    return create_mesh(meshVertices.data(), static_cast<uint32_t>(meshVertices.size()), meshIndices.data(), static_cast<uint32_t>(meshIndices.size()), vk::IndexType::eUint16, computeBoundingSphere(meshVertices));
+}
+
+std::vector<WMeshHandle> WRenderer::LoadMesh(const std::filesystem::path& path)
+{
+    WMappedFile file;
+    file.Open(path);
+    const std::span<const std::byte> data = file.GetData();
+
+    WMeshFileHeader header;
+    if (data.size() < sizeof(header))
+        WThrowException(path.string() + " is too small to be a cooked mesh");
+    memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != WMESH_MAGIC || header.version != WMESH_VERSION)
+        WThrowException(path.string() + " is not a cooked mesh of version " + std::to_string(WMESH_VERSION));
+    if (header.vertex_stride != sizeof(Vertex))
+        WThrowException(path.string() + " was cooked with another vertex layout");
+    if (header.parts_offset > data.size() || static_cast<uint64_t>(header.part_count) * sizeof(WMeshFilePart) > data.size() - header.parts_offset)
+        WThrowException(path.string() + " is truncated");
+
+    std::vector<WMeshFilePart> parts(header.part_count);
+    memcpy(parts.data(), data.data() + header.parts_offset, parts.size() * sizeof(WMeshFilePart));
+    for (const auto& part : parts)
+    {
+        const uint64_t vertexBytes = static_cast<uint64_t>(part.vertex_count) * sizeof(Vertex);
+        const uint64_t indexBytes = static_cast<uint64_t>(part.index_count) * sizeof(uint16_t);
+        if (part.vertex_offset > data.size() || vertexBytes > data.size() - part.vertex_offset ||
+            part.index_offset > data.size() || indexBytes > data.size() - part.index_offset)
+            WThrowException(path.string() + " is truncated");
+        if (part.vertex_count > WMESH_MAX_PART_VERTICES)
+            WThrowException(path.string() + " has a part too big for 16 bit indices");
+    }
+
+    // the blobs are copied from the mapped pages into the staging ring, the mapping can go once this returns
+    std::vector<WMeshHandle> meshes;
+    try
+    {
+        for (const auto& part : parts)
+            meshes.push_back(create_mesh(data.data() + part.vertex_offset, part.vertex_count, data.data() + part.index_offset, part.index_count, vk::IndexType::eUint16, part.bounding_sphere));
+    }
+    catch (...)
+    {
+        for (const WMeshHandle mesh : meshes)
+            DestroyMesh(mesh);
+        throw;
+    }
+    return meshes;
+}
+
+std::vector<WMeshHandle> WRenderer::ImportGltf(const std::filesystem::path& path)
+{
+    const WImportedMesh imported = importGltf(path);
+
+    std::vector<WMeshHandle> meshes;
+    try
+    {
+        for (const auto& part : imported.parts)
+            meshes.push_back(create_mesh(part.vertices.data(), static_cast<uint32_t>(part.vertices.size()), part.indices.data(), static_cast<uint32_t>(part.indices.size()), vk::IndexType::eUint16, part.bounding_sphere));
+    }
+    catch (...)
+    {
+        for (const WMeshHandle mesh : meshes)
+            DestroyMesh(mesh);
+        throw;
+    }
+    return meshes;
+}
+
+WMeshHandle WRenderer::create_mesh(const void* vertexData, const uint32_t vertexCount, const void* indexData, const uint32_t indexCount, const vk::IndexType indexType, const glm::vec4& boundingSphere)
+{
+    if (vertexCount == 0 || indexCount == 0)
+        WThrowException("can't create a mesh without geometry");
+
+    // the pool hands out 32 bit slots, 16 bit indices take half as many
+    const uint32_t indicesPerSlot = indexType == vk::IndexType::eUint16 ? 2 : 1;
+    const vk::DeviceSize indexBytes = static_cast<vk::DeviceSize>(indexCount) * (sizeof(uint32_t) / indicesPerSlot);
+    WGeometryRange geometry = geometry_pool.Allocate(vertexCount, (indexCount + indicesPerSlot - 1) / indicesPerSlot);
+    upload_manager.EnqueueBufferUpload(geometry_pool.GetVertexBuffer(), geometry_pool.GetVertexByteOffset(geometry), vertexData, vertexCount * sizeof(Vertex));
+    upload_manager.EnqueueBufferUpload(geometry_pool.GetIndexBuffer(), WGeometryPool::GetIndexByteOffset(geometry), indexData, indexBytes);
+
+    const WMeshDraw meshDraw {
+        .first_index = geometry.first_index * indicesPerSlot,
+        .index_count = indexCount,
+        .vertex_offset = static_cast<int32_t>(geometry.vertex_offset),
+        .index_type = indexType
+    };
+    const WMeshHandle mesh = mesh_pool.Allocate(meshDraw, boundingSphere, geometry);
+    if (!mesh)
+    {
+        geometry_pool.Free(geometry);
+        WThrowException("out of mesh handles");
+    }
+    return mesh;
+}
+
+void WRenderer::DestroyMesh(const WMeshHandle mesh)
+{
+    const uint32_t index = get_mesh_index(mesh);
+
+    deletion_queue.Push(frame_timeline_value + 1, [this, geometry = mesh_pool.GetColumn<MESH_GEOMETRY>()[index]]() mutable {
+        geometry_pool.Free(geometry);
+    });
+    mesh_pool.Free(mesh);
+}
+
+bool WRenderer::IsValid(const WMeshHandle mesh) const
+{
+    return mesh_pool.IsValid(mesh);
+}
+
+WGraphicsPipelineState WRenderer::GetDefaultPipelineState() const
+{
+    return default_pipeline_state;
+}
+
+WMaterialHandle WRenderer::CreateMaterial(const WGraphicsPipelineState& state)
+{
+    const WMaterialHandle material = material_pool.Allocate(state, pipeline_library.Find(state), WTextureHandle{});
+    if (!material)
+        WThrowException("out of material handles");
+    return material;
+}
+
+void WRenderer::DestroyMaterial(const WMaterialHandle material)
+{
+    material_pool.Free(material);
+}
+
+bool WRenderer::IsValid(const WMaterialHandle material) const
+{
+    return material_pool.IsValid(material);
+}
+
+bool WRenderer::IsMaterialReady(const WMaterialHandle material) const
+{
+    return material_pool.IsValid(material) && material_pool.Get<MATERIAL_PIPELINE>(material);
+}
+
+void WRenderer::SetMaterialTexture(const WMaterialHandle material, const WTextureHandle texture)
+{
+    if (!material_pool.IsValid(material))
+        WThrowException("invalid or destroyed material handle");
+    if (texture && !texture_pool.IsValid(texture))
+        WThrowException("invalid or destroyed texture handle");
+    material_pool.Get<MATERIAL_TEXTURE>(material) = texture;
+}
+
+WTextureHandle WRenderer::LoadTexture(const std::filesystem::path& path)
+{
+    auto source = std::make_unique<WKtxTexture>();
+    source->Open(path);
+
+    const vk::Format format = source->GetFormat();
+    constexpr vk::FormatFeatureFlags requiredFeatures =
+        vk::FormatFeatureFlagBits::eSampledImage |
+        vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+        vk::FormatFeatureFlagBits::eTransferDst;
+    if ((physical_device.getFormatProperties(format).optimalTilingFeatures & requiredFeatures) != requiredFeatures)
+        WThrowException(path.string() + " is in " + vk::to_string(format) + ", which the device can't sample");
+
+    // the first level that fits the placeholder size and every smaller one go up right away
+    const uint32_t levelCount = source->GetLevelCount();
+    uint32_t placeholderMip = 0;
+    while (placeholderMip + 1 < levelCount && std::max(source->GetExtent(placeholderMip).width, source->GetExtent(placeholderMip).height) > TEXTURE_PLACEHOLDER_SIZE)
+        placeholderMip++;
+
+    WTextureStream stream {
+        .format = format,
+        .level_count = levelCount,
+        .placeholder_mip = placeholderMip,
+        .resident_mip = placeholderMip,
+        .last_used = frame_timeline_value
+    };
+
+    // the full chain if there's room for it, otherwise just the placeholder until the residency manager finds some
+    residency_manager.Update();
+    vk::Image image = nullptr;
+    VmaAllocation allocation = nullptr;
+    if (source->GetChainSize(0) <= residency_manager.GetHeadroom())
+        std::tie(image, allocation) = create_texture_image(*source, 0, true, path.filename().string());
+    if (!image)
+    {
+        stream.base_mip = stream.target_mip = placeholderMip;
+        std::tie(image, allocation) = create_texture_image(*source, placeholderMip, false, path.filename().string());
+    }
+    if (!image)
+        WThrowException("failed to create the image of " + path.string());
+
+    const uint32_t baseMip = stream.base_mip;
+    const WTextureHandle texture = texture_pool.Allocate(image, allocation, nullptr, INVALID_BINDLESS_INDEX, std::move(stream));
+    if (!texture)
+    {
+        allocation_tracker.DestroyImage(image, allocation);
+        WThrowException("out of texture handles");
+    }
+
+    try
+    {
+        for (uint32_t level = placeholderMip; level < levelCount; level++)
+        {
+            const std::span<const std::byte> data = source->GetLevel(level);
+            upload_manager.EnqueueImageUpload(image, format, level - baseMip, source->GetExtent(level), data.data(), data.size());
+        }
+        update_texture_view(texture.GetIndex(), placeholderMip);
+    }
+    catch (...)
+    {
+        DestroyTexture(texture);
+        throw;
+    }
+
+    // the frame that first samples the texture waits for the placeholder upload like it does for new geometry
+    if (placeholderMip > 0)
+        texture_pool.Get<TEXTURE_STREAM>(texture).source = std::move(source);
+    return texture;
+}
+
+void WRenderer::DestroyTexture(const WTextureHandle texture)
+{
+    if (!texture_pool.IsValid(texture))
+        WThrowException("invalid or destroyed texture handle");
+
+    if (const WBindlessIndex index = texture_pool.Get<TEXTURE_INDEX>(texture); index != INVALID_BINDLESS_INDEX)
+        UnregisterImage(index);
+    if (const vk::ImageView view = texture_pool.Get<TEXTURE_VIEW>(texture))
+        deletion_queue.Release(frame_timeline_value + 1, vk::raii::ImageView(device, view));
+
+    // a streamed level or a rebuild may still be copying on the transfer queue, which the frame timeline knows nothing about
+    const WTextureStream& stream = texture_pool.Get<TEXTURE_STREAM>(texture);
+    deletion_queue.Push(frame_timeline_value + 1, [this, image = texture_pool.Get<TEXTURE_IMAGE>(texture), allocation = texture_pool.Get<TEXTURE_ALLOCATION>(texture),
+                                                   rebuildImage = stream.rebuild_image, rebuildAllocation = stream.rebuild_allocation,
+                                                   uploadValue = std::max(stream.pending_value, stream.rebuild_value)] {
+        release_texture_images(image, allocation, rebuildImage, rebuildAllocation, uploadValue);
+    });
+    texture_pool.Free(texture);
+}
+
+bool WRenderer::IsValid(const WTextureHandle texture) const
+{
+    return texture_pool.IsValid(texture);
+}
+
+WBindlessIndex WRenderer::GetTextureIndex(const WTextureHandle texture) const
+{
+    if (!texture_pool.IsValid(texture))
+        WThrowException("invalid or destroyed texture handle");
+    return texture_pool.Get<TEXTURE_INDEX>(texture);
+}
+
+uint32_t WRenderer::GetTextureResidentMip(const WTextureHandle texture) const
+{
+    if (!texture_pool.IsValid(texture))
+        WThrowException("invalid or destroyed texture handle");
+    return texture_pool.Get<TEXTURE_STREAM>(texture).resident_mip;
+}
+
+void WRenderer::SetTextureStreamBudget(const vk::DeviceSize bytesPerFrame)
+{
+    texture_stream_budget = bytesPerFrame;
+}
+
+void WRenderer::SetMemoryCeiling(const vk::DeviceSize bytes)
+{
+    residency_manager.SetCeiling(bytes);
+}
+
+vk::DeviceSize WRenderer::GetMemoryUsage() const
+{
+    return residency_manager.GetUsage();
+}
+
+vk::DeviceSize WRenderer::GetMemoryBudget() const
+{
+    return residency_manager.GetBudget();
+}
+
+WMemoryStats WRenderer::GetMemoryStats() const
+{
+    return allocation_tracker.GetStats();
+}
+
+std::string WRenderer::BuildMemoryReport(const bool detailed) const
+{
+    return allocation_tracker.BuildReport(detailed);
+}
+
+void WRenderer::WriteMemoryReport(const std::filesystem::path& path, const bool detailed) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+        WThrowException("failed to open " + path.string() + " for writing");
+    file << allocation_tracker.BuildReport(detailed);
+}
+
+void WRenderer::SetMemoryReportPath(const std::filesystem::path& path)
+{
+    memory_report_path = path;
+}
+
+WBindlessIndex WRenderer::GetDefaultSamplerIndex() const
+{
+    return default_sampler_index;
+}
+
+void WRenderer::Draw(const WMeshHandle mesh, const glm::mat4& transform, const WMaterialHandle material)
+{
+    const uint32_t index = get_mesh_index(mesh);
+    draw_list.push_back({
+        .mesh_index = index,
+        .transform = transform,
+        .bounding_sphere = mesh_pool.GetColumn<MESH_BOUNDS>()[index],
+        .material = material
+    });
+}
+
+void WRenderer::DrawInstanced(const WMeshHandle mesh, const std::span<const InstanceData> instances, const WMaterialHandle material)
+{
+    const uint32_t index = get_mesh_index(mesh);
+    const glm::vec4 meshSphere = mesh_pool.GetColumn<MESH_BOUNDS>()[index];
+    if (instances.empty())
+        return;
+
+    // one world space sphere around all instances, so the cull pass can treat the whole batch as one object
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (const auto& instance : instances)
+    {
+        const glm::vec3 center = instance.transform * glm::vec4(glm::vec3(meshSphere), 1.f);
+        boundsMin = glm::min(boundsMin, center);
+        boundsMax = glm::max(boundsMax, center);
+    }
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    float radius = 0.f;
+    for (const auto& instance : instances)
+    {
+        const float scale = std::max({glm::length(glm::vec3(instance.transform[0])), glm::length(glm::vec3(instance.transform[1])), glm::length(glm::vec3(instance.transform[2]))});
+        const glm::vec3 instanceCenter = instance.transform * glm::vec4(glm::vec3(meshSphere), 1.f);
+        radius = std::max(radius, glm::length(instanceCenter - center) + meshSphere.w * scale);
+    }
+
+    draw_list.push_back({
+        .mesh_index = index,
+        .transform = glm::mat4(1.f),
+        .bounding_sphere = glm::vec4(center, radius),
+        .first_instance = static_cast<uint32_t>(instance_list.size()),
+        .instance_count = static_cast<uint32_t>(instances.size()),
+        .material = material
+    });
+    instance_list.insert(instance_list.end(), instances.begin(), instances.end());
+}
+
+void WRenderer::SetCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+    custom_camera = true;
+    camera_view = view;
+    camera_projection = projection;
+}
+
 void WRenderer::Cleanup()
 {
     destroy_vulkan();
 
+    if (headless) return;
+
     glfwDestroyWindow(window);
     glfwTerminate();
 }
 
 void WRenderer::DrawFrame()
 {
-    if (device.waitForFences(*in_flight_fences[frame_index], vk::True, UINT64_MAX) != vk::Result::eSuccess)
-        WThrowException("failed to wait for fence(s)!");
-    device.resetFences(*in_flight_fences[frame_index]);
-
-    auto [result, imageIndex] = swap_chain.acquireNextImage(UINT64_MAX, *present_complete_semaphores[frame_index], nullptr);
-    switch (result)
+    profiler.BeginFrame(frame_index);
     {
-    case vk::Result::eSuccess:
-    case vk::Result::eSuboptimalKHR:
-        break;
+        WCpuZone zone(profiler, "wait");
+        WaitForFrameValue(frame_slot_values[frame_index]);
+    }
+    deletion_queue.Collect(GetCompletedFrameValue());
+    apply_reloaded_shaders();
+    update_material_pipelines();
+    profiler.ResolveFrame(frame_index);
+    frame_allocator.BeginFrame(frame_index);
+
+    // headless targets are owned by the frame, so there is nothing to acquire or present
+    uint32_t imageIndex = frame_index;
+    bool windowClosed = false;
+    if (!headless)
+    {
+        WCpuZone zone(profiler, "acquire");
+        while (true)
+        {
+            const auto [result, acquiredImageIndex] = swap_chain.acquireNextImage(UINT64_MAX, *present_complete_semaphores[frame_index], nullptr);
+            if (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR)
+            {
+                imageIndex = acquiredImageIndex;
+                break;
+            }
+            if (result != vk::Result::eErrorOutOfDateKHR)
+                WThrowException("failed to acquire swap chain image");
 
-    case vk::Result::eErrorOutOfDateKHR:
-        recreate_swap_chain();
-        break;
+            // a failed acquire leaves the semaphore unsignaled, so it can be used again right away on the new swap chain
+            recreate_swap_chain();
+            if (glfwWindowShouldClose(window))
+            {
+                windowClosed = true;
+                break;
+            }
+        }
+    }
+    // the frame is dropped without a submit, but the profiler still has to close it so its frame numbers stay in order
+    if (windowClosed)
+    {
+        draw_list.clear();
+        instance_list.clear();
+        profiler.EndFrame();
+        return;
+    }
 
-    default:
-        WThrowException("failed to acquire swap chain image");
+    {
+        WCpuZone zone(profiler, "record");
+        build_draw_batches();
+        update_frame_constants();
+        write_gpu_objects();
+        command_buffers[frame_index].reset();
+        record_command_buffer(imageIndex);
+        draw_list.clear();
+        instance_list.clear();
+        frame_allocator.Flush();
     }
 
-    command_buffers[frame_index].reset();
-    record_command_buffer(imageIndex);
+    {
+        WCpuZone zone(profiler, "submit");
+        // all uploads queued this frame go out as one transfer batch, the frame only waits for it where geometry is consumed
+        const uint64_t uploadValue = upload_manager.Flush();
+
+        std::array<vk::SemaphoreSubmitInfo, 2> waitSIs;
+        uint32_t waitCount = 0;
+        if (!headless)
+            waitSIs[waitCount++] = {
+                .semaphore = *present_complete_semaphores[frame_index],
+                .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput
+            };
+        // a batch of streamed mips is only published once it's done, so a frame never waits for one to finish
+        uint64_t uploadWaitValue = texture_published_value;
+        if (uploadValue > upload_manager.GetCompletedValue() && uploadValue != texture_stream_value)
+            uploadWaitValue = std::max(uploadWaitValue, uploadValue);
+        if (uploadWaitValue > 0)
+            waitSIs[waitCount++] = {
+                .semaphore = upload_manager.GetTimelineSemaphore(),
+                .value = uploadWaitValue,
+                .stageMask = UPLOAD_CONSUMER_STAGES
+            };
+
+        const vk::CommandBufferSubmitInfo commandBufferSI {.commandBuffer = *command_buffers[frame_index]};
+
+        // the timeline is signaled once all commands are done, since everything that waits on it reuses or frees their resources
+        frame_slot_values[frame_index] = ++frame_timeline_value;
+        std::array<vk::SemaphoreSubmitInfo, 2> signalSIs;
+        uint32_t signalCount = 0;
+        signalSIs[signalCount++] = {
+            .semaphore = *frame_timeline,
+            .value = frame_timeline_value,
+            .stageMask = vk::PipelineStageFlagBits2::eAllCommands
+        };
+        if (!headless)
+            signalSIs[signalCount++] = {
+                .semaphore = *render_finished_semaphores[imageIndex],
+                .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput
+            };
+
+        const vk::SubmitInfo2 submitI {
+            .waitSemaphoreInfoCount = waitCount,
+            .pWaitSemaphoreInfos = waitSIs.data(),
+            .commandBufferInfoCount = 1,
+            .pCommandBufferInfos = &commandBufferSI,
+            .signalSemaphoreInfoCount = signalCount,
+            .pSignalSemaphoreInfos = signalSIs.data()
+        };
 
-    constexpr vk::PipelineStageFlags waitDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-    const vk::SubmitInfo submitI {
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &*present_complete_semaphores[frame_index],
-        .pWaitDstStageMask = &waitDstStageMask,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &*command_buffers[frame_index],
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores = &*render_finished_semaphores[imageIndex]
-    };
+        graphics_queue.submit2(submitI);
+    }
 
-    graphics_queue.submit(submitI, *in_flight_fences[frame_index]);
+    {
+        WCpuZone zone(profiler, "stream");
+        update_texture_residency();
+        stream_textures();
+    }
 
-    const vk::PresentInfoKHR presentI {
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &*render_finished_semaphores[imageIndex],
-        .swapchainCount = 1,
-        .pSwapchains = &*swap_chain,
-        .pImageIndices = &imageIndex
-    };
-    result = graphics_queue.presentKHR(presentI);
-    if (frame_buffer_resized)
+    if (headless)
     {
-        frame_buffer_resized = false;
-        recreate_swap_chain();
+        if (frame_buffer_resized)
+        {
+            frame_buffer_resized = false;
+            recreate_swap_chain();
+        }
     }
-    switch (result)
+    else
     {
-    case vk::Result::eErrorOutOfDateKHR:
-    case vk::Result::eSuboptimalKHR:
-        recreate_swap_chain();
-        break;
-
-    case vk::Result::eSuccess:
-        break;
+        WCpuZone zone(profiler, "present");
+        const vk::PresentInfoKHR presentI {
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &*render_finished_semaphores[imageIndex],
+            .swapchainCount = 1,
+            .pSwapchains = &*swap_chain,
+            .pImageIndices = &imageIndex
+        };
+        const auto result = graphics_queue.presentKHR(presentI);
+        if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR && result != vk::Result::eErrorOutOfDateKHR)
+            WThrowException("failed to present swap chain image");
 
-    default:
-        WThrowException("failed to present swap chain image");
+        if (frame_buffer_resized || result != vk::Result::eSuccess)
+        {
+            frame_buffer_resized = false;
+            recreate_swap_chain();
+        }
     }
 
-    frame_index = (frame_index + 1) % MAX_FRAMES_IN_FLIGHT;
+    profiler.EndFrame();
+    frame_index = (frame_index + 1) % frames_in_flight;
 }
 
 void WRenderer::WThrowException(const std::string& message, const int line)
@@ -194,10 +988,13 @@ std::vector<const char*> WRenderer::get_required_layers() const
 
 std::vector<const char*> WRenderer::get_required_extensions() const
 {
-    uint32_t glfwExtensionCount = 0;
-    const auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-    std::vector requiredExtensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    std::vector<const char*> requiredExtensions;
+    if (!headless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        requiredExtensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
     if (enableValidationLayers)
         requiredExtensions.push_back(vk::EXTDebugUtilsExtensionName);
 
@@ -296,7 +1093,18 @@ void WRenderer::create_logical_device()
                                                                   }
     );
     uint32_t graphicsIndex = std::ranges::distance(queueFamilyProperties.begin(), graphicsQueueFamilyProperty);
-    const uint32_t presentationIndex = get_presentation_qfp_index(graphicsIndex);
+    const uint32_t presentationIndex = headless ? graphicsIndex : get_presentation_qfp_index(graphicsIndex);
+
+    // a transfer only family is usually backed by a dma engine that copies alongside the graphics work
+    const auto transferQueueFamilyProperty = std::ranges::find_if(queueFamilyProperties,
+                                                                  [](const auto& qfp) {
+                                                                      return (qfp.queueFlags & vk::QueueFlagBits::eTransfer) &&
+                                                                          !(qfp.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute));
+                                                                  }
+    );
+    transfer_queue_index = transferQueueFamilyProperty != queueFamilyProperties.end()
+        ? static_cast<uint32_t>(std::ranges::distance(queueFamilyProperties.begin(), transferQueueFamilyProperty))
+        : graphicsIndex;
 
     vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures {
         .pNext = nullptr,
@@ -309,14 +1117,33 @@ void WRenderer::create_logical_device()
     };
     vk::PhysicalDeviceVulkan12Features vulkan12Features {
         .pNext = &vulkan13Features,
+        .drawIndirectCount = true,
+        .descriptorIndexing = true,
+        .shaderSampledImageArrayNonUniformIndexing = true,
+        .shaderStorageBufferArrayNonUniformIndexing = true,
+        .descriptorBindingSampledImageUpdateAfterBind = true,
+        .descriptorBindingStorageBufferUpdateAfterBind = true,
+        .descriptorBindingUpdateUnusedWhilePending = true,
+        .descriptorBindingPartiallyBound = true,
+        .runtimeDescriptorArray = true,
+        .timelineSemaphore = true,
         .bufferDeviceAddress = true
     };
     vk::PhysicalDeviceVulkan11Features vulkan11Features {
         .pNext = &vulkan12Features,
         .shaderDrawParameters = true
     };
+    // compressed formats are enabled wherever they exist, textures in a format the device lacks are rejected when they're loaded
+    const vk::PhysicalDeviceFeatures supportedFeatures = physical_device.getFeatures();
     vk::PhysicalDeviceFeatures2 physicalDeviceFeatures2 {
-        .pNext = &vulkan11Features
+        .pNext = &vulkan11Features,
+        .features = {
+            .multiDrawIndirect = true,
+            .samplerAnisotropy = supportedFeatures.samplerAnisotropy,
+            .textureCompressionETC2 = supportedFeatures.textureCompressionETC2,
+            .textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR,
+            .textureCompressionBC = supportedFeatures.textureCompressionBC
+        }
     };
 
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos {};
@@ -338,6 +1165,22 @@ void WRenderer::create_logical_device()
         queueCreateInfos.push_back(presentQueueCI);
     }
 
+    if (transfer_queue_index != graphicsIndex && transfer_queue_index != presentationIndex)
+    {
+        const vk::DeviceQueueCreateInfo transferQueueCI {
+            .queueFamilyIndex = transfer_queue_index,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        };
+        queueCreateInfos.push_back(transferQueueCI);
+    }
+
+    // optional, lets the residency manager see what the driver grants this process instead of guessing from the heap sizes
+    const auto extensions = physical_device.enumerateDeviceExtensionProperties();
+    memory_budget_supported = std::ranges::any_of(extensions, [](const auto& ext) { return strcmp(ext.extensionName, vk::EXTMemoryBudgetExtensionName) == 0; });
+    if (memory_budget_supported)
+        device_extensions.push_back(vk::EXTMemoryBudgetExtensionName);
+
     const vk::DeviceCreateInfo deviceCI {
         .pNext = &physicalDeviceFeatures2,
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
@@ -349,6 +1192,10 @@ void WRenderer::create_logical_device()
 
     graphics_queue = device.getQueue(graphicsIndex, 0);
     present_queue = device.getQueue(presentationIndex, 0);
+
+    buffer_queue_families.clear();
+    if (transfer_queue_index != graphicsIndex)
+        buffer_queue_families = {graphicsIndex, transfer_queue_index};
 }
 
 uint32_t WRenderer::get_presentation_qfp_index(uint32_t& graphicsIndex) const
@@ -399,17 +1246,20 @@ void WRenderer::vma_init()
         .vkGetDeviceProcAddr = vkGetDeviceProcAddr,
         .vkCreateImage = vkCreateImage
     };
+    // without the budget extension VMA falls back to estimating the budget from its own allocations
     const VmaAllocatorCreateInfo allocatorCI {
-        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT | (memory_budget_supported ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u),
         .physicalDevice = *physical_device,
         .device = *device,
         .pVulkanFunctions = &vkFunctions,
-        .instance = *instance
+        .instance = *instance,
+        .vulkanApiVersion = vk::ApiVersion13
     };
-    vmaCreateAllocator(&allocatorCI, &allocator);
+    if (const VkResult result = vmaCreateAllocator(&allocatorCI, &allocator); result != VK_SUCCESS)
+        WThrowException("failed to create the allocator: " + vk::to_string(static_cast<vk::Result>(result)));
 }
 
-void WRenderer::create_swap_chain()
+void WRenderer::create_swap_chain(const vk::SwapchainKHR oldSwapChain)
 {
     const auto swapSurfaceCapabilities = physical_device.getSurfaceCapabilitiesKHR(*surface);
     const auto [format, colorSpace] = chooseSwapSurfaceFormat(physical_device.getSurfaceFormatsKHR(*surface));
@@ -420,7 +1270,7 @@ void WRenderer::create_swap_chain()
         .minImageCount = chooseSwapMinImageCount(swapSurfaceCapabilities),
         .imageFormat = swap_chain_image_format = format,
         .imageColorSpace = colorSpace,
-        .imageExtent = swap_chain_extent = chooseSwapExtent(swapSurfaceCapabilities, window),
+        .imageExtent = swap_chain_extent = chooseSwapExtent(swapSurfaceCapabilities, {framebuffer_width, framebuffer_height}),
         .imageArrayLayers = 1,
         .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
         .imageSharingMode = vk::SharingMode::eExclusive,
@@ -428,13 +1278,49 @@ void WRenderer::create_swap_chain()
         .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
         .presentMode = chooseSwapPresentMode(physical_device.getSurfacePresentModesKHR(*surface)),
         .clipped = vk::True,
-        .oldSwapchain = VK_NULL_HANDLE
+        .oldSwapchain = oldSwapChain
     };
 
     swap_chain = device.createSwapchainKHR(swapChainCI);
     swap_chain_images = swap_chain.getImages();
 }
 
+void WRenderer::create_offscreen_images()
+{
+    swap_chain_image_format = vk::Format::eB8G8R8A8Srgb;
+    swap_chain_extent = vk::Extent2D{width, height};
+
+    const vk::ImageCreateInfo imageCI {
+        .imageType = vk::ImageType::e2D,
+        .format = swap_chain_image_format,
+        .extent = {swap_chain_extent.width, swap_chain_extent.height, 1},
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined
+    };
+    constexpr VmaAllocationCreateInfo allocationCI {
+        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY
+    };
+
+    // one target per frame in flight, waiting on the frame slot already guarantees the previous use has finished
+    for (size_t i = 0; i < frames_in_flight; i++)
+    {
+        VkImage image;
+        VmaAllocation allocation;
+        if (const VkResult result = vmaCreateImage(allocator, &*imageCI, &allocationCI, &image, &allocation, nullptr); result != VK_SUCCESS)
+            WThrowException("failed to create offscreen image: " + vk::to_string(static_cast<vk::Result>(result)));
+        allocation_tracker.Track(allocation, ALLOCATION_RENDER_TARGET, "offscreen target");
+
+        swap_chain_images.emplace_back(image);
+        offscreen_image_allocs.emplace_back(allocation);
+    }
+}
+
 void WRenderer::create_image_views()
 {
     swap_chain_image_views.clear();
@@ -445,359 +1331,908 @@ void WRenderer::create_image_views()
         .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
     };
 
-    for (const auto& image : swap_chain_images)
+    for (const auto& image : swap_chain_images)
+    {
+        imageViewCI.image = image;
+        swap_chain_image_views.emplace_back(device, imageViewCI);
+    }
+}
+
+void WRenderer::create_present_semaphores()
+{
+    // one per image, the image count may change whenever the swap chain is recreated
+    render_finished_semaphores.clear();
+    for (size_t i = 0; i < swap_chain_images.size(); i++)
+        render_finished_semaphores.emplace_back(device, vk::SemaphoreCreateInfo());
+}
+
+void WRenderer::create_descriptor_set_layout()
+{
+    constexpr std::array layoutBindings {
+        // frame constants
+        vk::DescriptorSetLayoutBinding {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eUniformBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eVertex,
+            .pImmutableSamplers = nullptr
+        },
+        // gpu objects
+        vk::DescriptorSetLayoutBinding {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eStorageBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eVertex,
+            .pImmutableSamplers = nullptr
+        }
+    };
+    const vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCI {
+        .bindingCount = static_cast<uint32_t>(layoutBindings.size()),
+        .pBindings = layoutBindings.data()
+    };
+    descriptor_set_layout = {device, descriptorSetLayoutCI};
+
+    constexpr std::array cullLayoutBindings {
+        // gpu objects
+        vk::DescriptorSetLayoutBinding {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eStorageBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute
+        },
+        // draw commands
+        vk::DescriptorSetLayoutBinding {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute
+        },
+        // draw count
+        vk::DescriptorSetLayoutBinding {
+            .binding = 2,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute
+        }
+    };
+    const vk::DescriptorSetLayoutCreateInfo cullDescriptorSetLayoutCI {
+        .bindingCount = static_cast<uint32_t>(cullLayoutBindings.size()),
+        .pBindings = cullLayoutBindings.data()
+    };
+    cull_descriptor_set_layout = {device, cullDescriptorSetLayoutCI};
+}
+
+void WRenderer::create_pipeline_cache()
+{
+    if (pipeline_cache_path.empty())
+        pipeline_cache_path = std::filesystem::temp_directory_path() / "WyrmEngine" / "pipeline_cache.bin";
+
+    std::vector<char> cacheData;
+    if (std::ifstream file(pipeline_cache_path, std::ios::ate | std::ios::binary); file.is_open())
+    {
+        cacheData.resize(file.tellg());
+        file.seekg(0, std::ios::beg);
+        file.read(cacheData.data(), static_cast<std::streamsize>(cacheData.size()));
+    }
+
+    // a cache from another driver or gpu would just be ignored by most drivers, but not all of them handle it gracefully
+    if (!isPipelineCacheCompatible(cacheData, physical_device.getProperties()))
+        cacheData.clear();
+
+    const vk::PipelineCacheCreateInfo pipelineCacheCI {
+        .initialDataSize = cacheData.size(),
+        .pInitialData = cacheData.empty() ? nullptr : cacheData.data()
+    };
+    pipeline_cache = {device, pipelineCacheCI};
+}
+
+void WRenderer::save_pipeline_cache() const
+{
+    if (!*pipeline_cache) return;
+
+    const auto cacheData = pipeline_cache.getData();
+    if (cacheData.empty()) return;
+
+    // written next to the real file and renamed over it, so a crash mid write never leaves a truncated cache behind
+    std::error_code error;
+    std::filesystem::create_directories(pipeline_cache_path.parent_path(), error);
+
+    auto temporaryPath = pipeline_cache_path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+        if (!file.good())
+        {
+            std::cerr << "failed to write pipeline cache to " << temporaryPath << std::endl;
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, pipeline_cache_path, error);
+    if (error)
+        std::cerr << "failed to replace pipeline cache " << pipeline_cache_path << ": " << error.message() << std::endl;
+}
+
+void WRenderer::create_graphics_pipeline()
+{
+    // set 0 changes with the frame, set 1 is the bindless heap
+    const std::array setLayouts {*descriptor_set_layout, bindless_heap.GetLayout()};
+    const vk::PipelineLayoutCreateInfo pipelineLayoutCI {
+        .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+        .pSetLayouts = setLayouts.data()
+    };
+    pipeline_layout = {device, pipelineLayoutCI};
+
+    // a couple of threads is plenty, they only ever run when a new state shows up
+    pipeline_library.Init(device, pipeline_cache, *pipeline_layout, std::clamp(std::thread::hardware_concurrency() / 4, 1u, MAX_PIPELINE_COMPILE_THREADS));
+    scene_shader = pipeline_library.AddShader(SHADER_SPIRV, "vertMain", "fragMain");
+
+    constexpr auto vertexBindingDescription = Vertex::GetBindingDescription();
+    constexpr auto vertexAttributeDescriptions = Vertex::GetAttributeDescriptions();
+    default_pipeline_state = {
+        .shader = scene_shader,
+        .vertex_layout = {
+            .stride = vertexBindingDescription.stride,
+            .attribute_count = static_cast<uint32_t>(vertexAttributeDescriptions.size())
+        },
+        .color_format = swap_chain_image_format
+    };
+    std::ranges::copy(vertexAttributeDescriptions, default_pipeline_state.vertex_layout.attributes.begin());
+
+    // the default pipeline is what pending materials fall back to, so it's the one pipeline built up front
+    graphics_pipeline = add_pipeline(pipeline_library.Build(default_pipeline_state), vk::PipelineBindPoint::eGraphics);
+}
+
+void WRenderer::create_cull_pipeline()
+{
+    constexpr vk::PushConstantRange pushConstantRange {
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = sizeof(CullConstants)
+    };
+    const vk::PipelineLayoutCreateInfo pipelineLayoutCI {
+        .setLayoutCount = 1,
+        .pSetLayouts = &*cull_descriptor_set_layout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    cull_pipeline_layout = {device, pipelineLayoutCI};
+
+    const auto shaderModule = create_shader_module(CULL_SPIRV);
+    cull_pipeline = add_pipeline(build_cull_pipeline(shaderModule), vk::PipelineBindPoint::eCompute);
+}
+
+vk::raii::Pipeline WRenderer::build_cull_pipeline(const vk::raii::ShaderModule& shaderModule) const
+{
+    const vk::ComputePipelineCreateInfo pipelineCI {
+        .stage = {
+            .stage = vk::ShaderStageFlagBits::eCompute,
+            .module = shaderModule,
+            .pName = "cullMain"
+        },
+        .layout = cull_pipeline_layout
+    };
+    return {device, pipeline_cache, pipelineCI};
+}
+
+void WRenderer::start_shader_hot_reload()
+{
+    if (!WShaderHotReload::IsAvailable()) return;
+
+#ifdef WYRM_SHADER_SOURCE_DIR
+    // the order has to match WShaderProgramIndex
+    shader_hot_reload.Start(WYRM_SHADER_SOURCE_DIR, {
+        {.module = "shader", .entry_points = {"vertMain", "fragMain"}},
+        {.module = "cull", .entry_points = {"cullMain"}}
+    });
+#endif
+}
+
+vk::raii::ShaderModule WRenderer::create_shader_module(const std::span<const uint32_t> code) const
+{
+    const vk::ShaderModuleCreateInfo shaderModuleCI {
+        .codeSize = code.size_bytes(),
+        .pCode = code.data()
+    };
+
+    return {device, shaderModuleCI};
+}
+
+void WRenderer::apply_reloaded_shaders()
+{
+    for (const auto& compiled : shader_hot_reload.TakeCompiled())
+    {
+        // a shader that compiles can still be rejected by the driver, the old pipeline stays in that case
+        try
+        {
+            if (compiled.program == SCENE_PROGRAM)
+            {
+                // every material built from the scene shader recompiles in the background and falls back meanwhile
+                for (auto& dropped : pipeline_library.ReplaceShader(scene_shader, compiled.spirv))
+                    Release(std::move(dropped));
+                material_pool.ForEach([this](const WMaterialHandle material) {
+                    material_pool.Get<MATERIAL_PIPELINE>(material) = pipeline_library.Find(material_pool.Get<MATERIAL_STATE>(material));
+                });
+
+                auto pipeline = pipeline_library.Build(default_pipeline_state);
+                destroy_pipeline(graphics_pipeline);
+                graphics_pipeline = add_pipeline(std::move(pipeline), vk::PipelineBindPoint::eGraphics);
+            }
+            else if (compiled.program == CULL_PROGRAM)
+            {
+                const auto shaderModule = create_shader_module(compiled.spirv);
+                auto pipeline = build_cull_pipeline(shaderModule);
+                destroy_pipeline(cull_pipeline);
+                cull_pipeline = add_pipeline(std::move(pipeline), vk::PipelineBindPoint::eCompute);
+            }
+        }
+        catch (const vk::SystemError& e)
+        {
+            std::cerr << "Shader reload failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+void WRenderer::create_command_pool()
+{
+    const vk::CommandPoolCreateInfo poolCI {
+        .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = queue_index
+    };
+    command_pool = {device, poolCI};
+}
+
+void WRenderer::create_record_slots()
+{
+    if (record_thread_count == 0)
+        record_thread_count = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+    // pools are externally synchronized, a slot only ever runs on one thread at a time so it never needs a lock
+    record_slots.clear();
+    for (uint32_t i = 0; i < record_thread_count * frames_in_flight; i++)
     {
-        imageViewCI.image = image;
-        swap_chain_image_views.emplace_back(device, imageViewCI);
+        const vk::CommandPoolCreateInfo poolCI {
+            .flags = vk::CommandPoolCreateFlagBits::eTransient,
+            .queueFamilyIndex = queue_index
+        };
+        WRecordSlot slot {.pool = {device, poolCI}};
+
+        const vk::CommandBufferAllocateInfo allocateI {
+            .commandPool = slot.pool,
+            .level = vk::CommandBufferLevel::eSecondary,
+            .commandBufferCount = 1
+        };
+        slot.secondary = std::move(vk::raii::CommandBuffers(device, allocateI).front());
+        record_slots.push_back(std::move(slot));
     }
+
+    if (!parallel_for)
+        worker_pool.Start(record_thread_count - 1);
 }
 
-void WRenderer::create_descriptor_set_layout()
+void WRenderer::create_command_buffers()
 {
-    vk::DescriptorSetLayoutBinding uboLayoutBinding {
-        .binding = 0,
-        .descriptorType = vk::DescriptorType::eUniformBuffer,
-        .descriptorCount = 1,
-        .stageFlags = vk::ShaderStageFlagBits::eVertex,
-        .pImmutableSamplers = nullptr
-    };
-    vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCI {
-        .bindingCount = 1,
-        .pBindings = &uboLayoutBinding
+    const vk::CommandBufferAllocateInfo allocateI {
+        .commandPool = command_pool,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = frames_in_flight
     };
-    descriptor_set_layout = {device, descriptorSetLayoutCI};
+    command_buffers = vk::raii::CommandBuffers(device, allocateI);
 }
 
-void WRenderer::create_graphics_pipeline()
+void WRenderer::create_descriptor_pool()
 {
-    const auto shaderModule = create_shader_module(readShaderFile("src/shader.spv"));
-    const vk::PipelineShaderStageCreateInfo vertexShaderCI {
-        .stage = vk::ShaderStageFlagBits::eVertex,
-        .module = shaderModule,
-        .pName = "vertMain"
-    };
-    const vk::PipelineShaderStageCreateInfo fragmentShaderCI {
-        .stage = vk::ShaderStageFlagBits::eFragment,
-        .module = shaderModule,
-        .pName = "fragMain"
+    // one graphics set plus a cull set per frame in flight
+    const std::array descriptorPoolSizes {
+        vk::DescriptorPoolSize {
+            .type = vk::DescriptorType::eUniformBufferDynamic,
+            .descriptorCount = 1
+        },
+        vk::DescriptorPoolSize {
+            .type = vk::DescriptorType::eStorageBufferDynamic,
+            .descriptorCount = 1 + frames_in_flight
+        },
+        vk::DescriptorPoolSize {
+            .type = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 2 * frames_in_flight
+        }
     };
-    const vk::PipelineShaderStageCreateInfo shaderStages[] = {vertexShaderCI, fragmentShaderCI};
-
-    constexpr auto vertexBindingDescription = Vertex::GetBindingDescription();
-    constexpr auto vertexAttributeDescriptions = Vertex::GetAttributeDescriptions();
-    // ReSharper disable once CppVariableCanBeMadeConstexpr <- you can't actually make this into a constexpr because of the pointers
-    const vk::PipelineVertexInputStateCreateInfo vertexInputCI {
-        .vertexBindingDescriptionCount = 1,
-        .pVertexBindingDescriptions = &vertexBindingDescription,
-        .vertexAttributeDescriptionCount = vertexAttributeDescriptions.size(),
-        .pVertexAttributeDescriptions = vertexAttributeDescriptions.data(),
-    };
-    constexpr vk::PipelineInputAssemblyStateCreateInfo inputAssemblyCI {
-        .topology = vk::PrimitiveTopology::eTriangleList
-    };
-
-    const std::vector dynamicStates = {
-        vk::DynamicState::eViewport,
-        vk::DynamicState::eScissor
-    };
-    const vk::PipelineDynamicStateCreateInfo dynamicStateCI {
-        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
-        .pDynamicStates = dynamicStates.data()
-    };
-
-    constexpr vk::PipelineViewportStateCreateInfo viewPortCI {
-        .viewportCount = 1,
-        .scissorCount = 1
-    };
-    constexpr vk::PipelineRasterizationStateCreateInfo rasterizerCI {
-        .depthClampEnable = vk::False,
-        .rasterizerDiscardEnable = vk::False,
-        .polygonMode = vk::PolygonMode::eFill,
-        .cullMode = vk::CullModeFlagBits::eBack,
-        .frontFace = vk::FrontFace::eClockwise,
-        .depthBiasEnable = vk::False,
-        .lineWidth = 1.0f
-    };
-    constexpr vk::PipelineMultisampleStateCreateInfo multisamplingCI {
-        .rasterizationSamples = vk::SampleCountFlagBits::e1,
-        .sampleShadingEnable = vk::False
-    };
-    constexpr  vk::PipelineColorBlendAttachmentState colorBlendAttachment{
-        .blendEnable = vk::False,
-        .srcColorBlendFactor = vk::BlendFactor::eSrcAlpha,
-        .dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
-        .colorBlendOp = vk::BlendOp::eAdd,
-        .srcAlphaBlendFactor = vk::BlendFactor::eOne,
-        .dstAlphaBlendFactor = vk::BlendFactor::eZero,
-        .alphaBlendOp = vk::BlendOp::eAdd,
-        .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
-    };
-    // ReSharper disable once CppVariableCanBeMadeConstexpr <- you can't actually make this into a constexpr because of the pointer
-    const  vk::PipelineColorBlendStateCreateInfo colorBlendingCI {
-        .logicOpEnable = vk::False,
-        .attachmentCount = 1,
-        .pAttachments = &colorBlendAttachment
+    // ReSharper disable once CppVariableCanBeMadeConstexpr
+    const vk::DescriptorPoolCreateInfo descriptorPoolCI {
+        .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+        .maxSets = 1 + frames_in_flight,
+        .poolSizeCount = static_cast<uint32_t>(descriptorPoolSizes.size()),
+        .pPoolSizes = descriptorPoolSizes.data()
     };
+    descriptor_pool = {device, descriptorPoolCI};
+}
 
-    const vk::PipelineLayoutCreateInfo pipelineLayoutCI {
-        .setLayoutCount = 1,
+void WRenderer::create_descriptor_sets()
+{
+    const vk::DescriptorSetAllocateInfo descriptorSetAllocI {
+        .descriptorPool = descriptor_pool,
+        .descriptorSetCount = 1,
         .pSetLayouts = &*descriptor_set_layout,
-        .pushConstantRangeCount = 0
     };
-    pipeline_layout = {device, pipelineLayoutCI};
+    descriptor_set = std::move(device.allocateDescriptorSets(descriptorSetAllocI).front());
 
-    const vk::PipelineRenderingCreateInfo pipelineRenderingCI {
-        .colorAttachmentCount = 1,
-        .pColorAttachmentFormats = &swap_chain_image_format
+    // both bindings look into the frame allocator, the dynamic offsets pick the frame and object constants
+    const std::array bufferInfos {
+        vk::DescriptorBufferInfo {
+            .buffer = frame_allocator.GetBuffer(),
+            .offset = 0,
+            .range = sizeof(UniformBufferObject)
+        },
+        // whole size makes the range end at the end of the buffer wherever the dynamic offset points
+        vk::DescriptorBufferInfo {
+            .buffer = frame_allocator.GetBuffer(),
+            .offset = 0,
+            .range = vk::WholeSize
+        }
     };
-    const vk::GraphicsPipelineCreateInfo pipelineCI {
-        .pNext = &pipelineRenderingCI,
-        .stageCount = 2,
-        .pStages = shaderStages,
-        .pVertexInputState = &vertexInputCI,
-        .pInputAssemblyState = &inputAssemblyCI,
-        .pViewportState = &viewPortCI,
-        .pRasterizationState = &rasterizerCI,
-        .pMultisampleState = &multisamplingCI,
-        .pColorBlendState = &colorBlendingCI,
-        .pDynamicState = &dynamicStateCI,
-        .layout = pipeline_layout,
-        .renderPass = nullptr
+    const std::array descriptorWrites {
+        vk::WriteDescriptorSet {
+            .dstSet = *descriptor_set,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eUniformBufferDynamic,
+            .pBufferInfo = &bufferInfos[0]
+        },
+        vk::WriteDescriptorSet {
+            .dstSet = *descriptor_set,
+            .dstBinding = 1,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageBufferDynamic,
+            .pBufferInfo = &bufferInfos[1]
+        }
     };
+    device.updateDescriptorSets(descriptorWrites, {});
 
-    graphics_pipeline = {device, nullptr, pipelineCI};
+    std::vector cullLayouts(frames_in_flight, *cull_descriptor_set_layout);
+    const vk::DescriptorSetAllocateInfo cullDescriptorSetAllocI {
+        .descriptorPool = descriptor_pool,
+        .descriptorSetCount = static_cast<uint32_t>(cullLayouts.size()),
+        .pSetLayouts = cullLayouts.data(),
+    };
+    cull_descriptor_sets = device.allocateDescriptorSets(cullDescriptorSetAllocI);
+    indirect_buffers.resize(frames_in_flight);
 }
 
-vk::raii::ShaderModule WRenderer::create_shader_module(const std::vector<char>& code)
+void WRenderer::ensure_indirect_capacity(const uint32_t drawCount)
 {
-    vk::ShaderModuleCreateInfo shaderModuleCI {
-        .codeSize = code.size() * sizeof(char),
-        .pCode = reinterpret_cast<const uint32_t*>(code.data())
+    auto& buffers = indirect_buffers[frame_index];
+    if (drawCount <= buffers.capacity)
+        return;
+
+    destroy_indirect_buffers(buffers);
+    buffers.capacity = std::max({drawCount, buffers.capacity * 2, 1024u});
+    buffers.commands = CreateBuffer(
+        buffers.capacity * sizeof(vk::DrawIndexedIndirectCommand),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+        false,
+        ALLOCATION_INDIRECT,
+        "indirect commands"
+    );
+    // one count per batch, there are never more batches than draws
+    buffers.count = CreateBuffer(
+        buffers.capacity * sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        false,
+        ALLOCATION_INDIRECT,
+        "indirect counts"
+    );
+
+    const std::array bufferInfos {
+        vk::DescriptorBufferInfo {.buffer = frame_allocator.GetBuffer(), .offset = 0, .range = vk::WholeSize},
+        vk::DescriptorBufferInfo {.buffer = GetBuffer(buffers.commands), .offset = 0, .range = vk::WholeSize},
+        vk::DescriptorBufferInfo {.buffer = GetBuffer(buffers.count), .offset = 0, .range = vk::WholeSize}
     };
+    std::array<vk::WriteDescriptorSet, 3> descriptorWrites;
+    for (uint32_t i = 0; i < descriptorWrites.size(); i++)
+        descriptorWrites[i] = {
+            .dstSet = *cull_descriptor_sets[frame_index],
+            .dstBinding = i,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = i == 0 ? vk::DescriptorType::eStorageBufferDynamic : vk::DescriptorType::eStorageBuffer,
+            .pBufferInfo = &bufferInfos[i]
+        };
+    device.updateDescriptorSets(descriptorWrites, {});
+}
 
-    return {device, shaderModuleCI};
+void WRenderer::destroy_indirect_buffers(WIndirectBuffers& buffers)
+{
+    if (buffers.capacity == 0)
+        return;
+
+    DestroyBuffer(buffers.count);
+    DestroyBuffer(buffers.commands);
+    buffers = {};
 }
 
-void WRenderer::create_command_pool()
+void WRenderer::create_sync_object()
 {
-    const vk::CommandPoolCreateInfo poolCI {
-        .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-        .queueFamilyIndex = queue_index
+    assert(present_complete_semaphores.empty() && render_finished_semaphores.empty());
+
+    if (!headless)
+        create_present_semaphores();
+
+    for (size_t i = 0; i < frames_in_flight; i++)
+        present_complete_semaphores.emplace_back(device, vk::SemaphoreCreateInfo());
+
+    vk::SemaphoreTypeCreateInfo timelineCI {
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0
     };
-    command_pool = {device, poolCI};
+    frame_timeline = {device, vk::SemaphoreCreateInfo {.pNext = &timelineCI}};
+    frame_timeline_value = 0;
+    frame_slot_values.assign(frames_in_flight, 0);
 }
 
-void WRenderer::create_command_buffers()
+void WRenderer::update_frame_constants()
 {
-    const vk::CommandBufferAllocateInfo allocateI {
-        .commandPool = command_pool,
-        .level = vk::CommandBufferLevel::ePrimary,
-        .commandBufferCount = MAX_FRAMES_IN_FLIGHT
+    UniformBufferObject ubo{};
+    if (custom_camera)
+    {
+        ubo.view = camera_view;
+        ubo.projection = camera_projection;
+    }
+    else
+    {
+        ubo.view = glm::lookAt(glm::vec3(2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        ubo.projection = glm::perspective(glm::radians(45.0f), static_cast<float>(swap_chain_extent.width) / static_cast<float>(swap_chain_extent.height), 0.01f, 10.0f);
+        ubo.projection[1][1] *= -1;
+    }
+
+    frame_constants_offset = frame_allocator.Push(ubo).offset;
+
+    // planes point inwards, the near plane is the z row alone because vulkan clip space depth starts at 0
+    const glm::mat4 viewProjection = ubo.projection * ubo.view;
+    const auto row = [&](const int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+    frustum_planes = {
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(2),
+        row(3) - row(2)
     };
-    command_buffers = vk::raii::CommandBuffers(device, allocateI);
+    for (auto& plane : frustum_planes)
+        plane /= glm::length(glm::vec3(plane));
 }
 
-void WRenderer::create_vertex_buffer()
+void WRenderer::update_material_pipelines()
 {
-    const vk::DeviceSize bufferSize {sizeof(vertices[0]) * vertices.size()};
-    vk::Buffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-    create_buffer(
-        allocator,
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        VMA_MEMORY_USAGE_CPU_ONLY,
-        stagingBuffer,
-        stagingAllocation
-    );
-
-    void* data = nullptr;
-    vmaMapMemory(allocator, stagingAllocation, &data);
-    memcpy(data, vertices.data(), bufferSize);
-    vmaUnmapMemory(allocator, stagingAllocation);
+    if (!pipeline_library.CollectFinished()) return;
 
-    create_buffer(
-        allocator,
-        bufferSize,
-        vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-        VMA_MEMORY_USAGE_GPU_ONLY,
-        vertex_buffer,
-        vertex_buffer_alloc
-    );
+    material_pool.ForEach([this](const WMaterialHandle material) {
+        auto& pipeline = material_pool.Get<MATERIAL_PIPELINE>(material);
+        if (!pipeline)
+            pipeline = pipeline_library.Find(material_pool.Get<MATERIAL_STATE>(material));
+    });
+}
 
-    copy_buffer(stagingBuffer, vertex_buffer, bufferSize);
-    vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
+void WRenderer::create_default_sampler()
+{
+    const bool anisotropy = physical_device.getFeatures().samplerAnisotropy;
+    const vk::SamplerCreateInfo samplerCI {
+        .magFilter = vk::Filter::eLinear,
+        .minFilter = vk::Filter::eLinear,
+        .mipmapMode = vk::SamplerMipmapMode::eLinear,
+        .addressModeU = vk::SamplerAddressMode::eRepeat,
+        .addressModeV = vk::SamplerAddressMode::eRepeat,
+        .addressModeW = vk::SamplerAddressMode::eRepeat,
+        .mipLodBias = 0.f,
+        .anisotropyEnable = anisotropy,
+        .maxAnisotropy = anisotropy ? std::min(physical_device.getProperties().limits.maxSamplerAnisotropy, 8.f) : 1.f,
+        .compareEnable = vk::False,
+        .minLod = 0.f,
+        .maxLod = vk::LodClampNone
+    };
+    default_sampler = vk::raii::Sampler(device, samplerCI);
+    default_sampler_index = bindless_heap.RegisterSampler(*default_sampler);
 }
 
-void WRenderer::create_index_buffer()
+void WRenderer::update_texture_residency()
 {
-    const vk::DeviceSize bufferSize {sizeof(indices[0]) * indices.size()};
-    vk::Buffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-    create_buffer(
-        allocator,
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        VMA_MEMORY_USAGE_CPU_ONLY,
-        stagingBuffer,
-        stagingAllocation
-    );
+    residency_manager.Update();
+
+    auto& streams = texture_pool.GetColumn<TEXTURE_STREAM>();
+    const auto& allocations = texture_pool.GetColumn<TEXTURE_ALLOCATION>();
+    const auto allocationSize = [this](const VmaAllocation allocation) {
+        VmaAllocationInfo allocationI;
+        vmaGetAllocationInfo(allocator, allocation, &allocationI);
+        return allocationI.size;
+    };
 
-    void* data = nullptr;
-    vmaMapMemory(allocator, stagingAllocation, &data);
-    memcpy(data, indices.data(), bufferSize);
-    vmaUnmapMemory(allocator, stagingAllocation);
+    // what earlier frames already decided to free or take, so the same pressure isn't acted on twice
+    vk::DeviceSize shrinking = 0;
+    vk::DeviceSize growing = 0;
+    residency_order.clear();
+    for (uint32_t index = 0; index < streams.size(); index++)
+    {
+        const WTextureStream& stream = streams[index];
+        if (!stream.source) continue;
 
-    create_buffer(
-        allocator,
-        bufferSize,
-        vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-        VMA_MEMORY_USAGE_GPU_ONLY,
-        index_buffer,
-        index_buffer_alloc
-    );
+        const vk::DeviceSize size = allocationSize(allocations[index]);
+        if (stream.rebuild_value != 0)
+        {
+            // the new image is already allocated, the old one goes away as a whole
+            if (stream.rebuild_base_mip > stream.base_mip)
+                shrinking += size;
+        }
+        else if (stream.target_mip > stream.base_mip)
+            shrinking += size - std::min(stream.source->GetChainSize(stream.target_mip), size);
+        else if (stream.target_mip < stream.base_mip)
+            growing += stream.source->GetChainSize(stream.target_mip) - stream.source->GetChainSize(stream.base_mip);
+        else
+            residency_order.push_back(index);
+    }
 
-    copy_buffer(stagingBuffer, index_buffer, bufferSize);
-    vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
-}
+    if (const vk::DeviceSize excess = residency_manager.GetExcess(); excess > shrinking)
+    {
+        // growth is called off first, then the least recently drawn textures drop a mip each until the excess is covered
+        for (auto& stream : streams)
+            if (stream.source && stream.rebuild_value == 0 && stream.target_mip < stream.base_mip)
+                stream.target_mip = stream.base_mip;
+
+        std::ranges::stable_sort(residency_order, [&](const uint32_t a, const uint32_t b) { return streams[a].last_used < streams[b].last_used; });
+        vk::DeviceSize freed = shrinking;
+        for (const uint32_t index : residency_order)
+        {
+            if (freed >= excess) break;
 
-void WRenderer::copy_buffer(const vk::Buffer& srcBuffer, const vk::Buffer& dstBuffer, const vk::DeviceSize size) const
-{
-    const vk::CommandBufferAllocateInfo allocateI {
-        .commandPool = command_pool,
-        .level = vk::CommandBufferLevel::ePrimary,
-        .commandBufferCount = 1
-    };
-    const vk::raii::CommandBuffer commandCopyBuffer = std::move(device.allocateCommandBuffers(allocateI).front());
+            WTextureStream& stream = streams[index];
+            // the placeholder always stays, so every texture can still be sampled
+            if (stream.base_mip >= stream.placeholder_mip) continue;
 
-    commandCopyBuffer.begin(vk::CommandBufferBeginInfo {.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-    commandCopyBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy(0, 0, size));
-    commandCopyBuffer.end();
+            const vk::DeviceSize size = allocationSize(allocations[index]);
+            stream.target_mip = stream.base_mip + 1;
+            freed += size - std::min(stream.source->GetChainSize(stream.target_mip), size);
+        }
+        return;
+    }
 
-    graphics_queue.submit(vk::SubmitInfo {.commandBufferCount = 1, .pCommandBuffers = &*commandCopyBuffer}, nullptr);
-    graphics_queue.waitIdle();
+    // textures drawn lately grow back, the most recent first, each straight to the finest chain that still fits
+    vk::DeviceSize headroom = residency_manager.GetHeadroom();
+    headroom -= std::min(growing, headroom);
+    std::ranges::stable_sort(residency_order, [&](const uint32_t a, const uint32_t b) { return streams[a].last_used > streams[b].last_used; });
+    for (const uint32_t index : residency_order)
+    {
+        WTextureStream& stream = streams[index];
+        if (stream.last_used + TEXTURE_IDLE_FRAMES < frame_timeline_value) break;
+        if (stream.base_mip == 0) continue;
+
+        const vk::DeviceSize baseSize = stream.source->GetChainSize(stream.base_mip);
+        uint32_t targetMip = stream.base_mip;
+        while (targetMip > 0 && stream.source->GetChainSize(targetMip - 1) - baseSize <= headroom)
+            targetMip--;
+        if (targetMip == stream.base_mip) continue;
+
+        headroom -= stream.source->GetChainSize(targetMip) - baseSize;
+        stream.target_mip = targetMip;
+    }
 }
 
-void WRenderer::create_uniform_buffers()
+void WRenderer::stream_textures()
 {
-    uniform_buffers.clear();
-    uniform_buffer_allocs.clear();
-    uniform_buffers_mapped.clear();
+    // uploads queued outside of streaming go out on their own, frames wait for those
+    upload_manager.Flush();
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    const uint64_t completedValue = upload_manager.GetCompletedValue();
+    const auto& streams = texture_pool.GetColumn<TEXTURE_STREAM>();
+    const auto slotCount = static_cast<uint32_t>(streams.size());
+    vk::DeviceSize queuedBytes = 0;
+    bool queuedAny = false;
+
+    for (uint32_t i = 0; i < slotCount; i++)
     {
-        constexpr vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
-        vk::Buffer buffer;
-        VmaAllocation allocation;
-        create_buffer(
-            allocator,
-            bufferSize,
-            vk::BufferUsageFlagBits::eUniformBuffer,
-            VMA_MEMORY_USAGE_GPU_TO_CPU,
-            buffer,
-            allocation
-        );
-        uniform_buffers.emplace_back(buffer);
-        uniform_buffer_allocs.emplace_back(allocation);
+        const uint32_t index = (texture_stream_cursor + i) % slotCount;
+        auto& stream = texture_pool.GetColumn<TEXTURE_STREAM>()[index];
+        if (!stream.source) continue;
+
+        if (stream.rebuild_value != 0)
+        {
+            if (stream.rebuild_value > completedValue) continue;
+            texture_published_value = std::max(texture_published_value, stream.rebuild_value);
+            finish_texture_rebuild(index);
+        }
+        if (stream.pending_value != 0)
+        {
+            if (stream.pending_value > completedValue) continue;
+
+            texture_published_value = std::max(texture_published_value, stream.pending_value);
+            stream.pending_value = 0;
+            update_texture_view(index, stream.resident_mip - 1);
+        }
+
+        // shrinking rebuilds right away, growing once the current image is fully resident
+        const bool rebuild = stream.target_mip > stream.base_mip || (stream.target_mip < stream.base_mip && stream.resident_mip == stream.base_mip);
+        vk::DeviceSize bytes;
+        if (rebuild)
+            bytes = stream.source->GetChainSize(std::max(stream.resident_mip, stream.target_mip));
+        else if (stream.resident_mip > stream.base_mip)
+            bytes = stream.source->GetLevel(stream.resident_mip - 1).size();
+        else
+            continue;
+
+        // one upload per texture in flight, one over the budget still goes out if it's the first this frame
+        if (queuedAny && queuedBytes + bytes > texture_stream_budget)
+        {
+            texture_stream_cursor = index;
+            break;
+        }
 
-        void* data = nullptr;
-        vmaMapMemory(allocator, uniform_buffer_allocs[i], &data);
-        uniform_buffers_mapped.emplace_back(data);
+        if (rebuild)
+        {
+            if (!begin_texture_rebuild(index)) continue;
+        }
+        else
+        {
+            const uint32_t level = stream.resident_mip - 1;
+            const std::span<const std::byte> data = stream.source->GetLevel(level);
+            upload_manager.EnqueueImageUpload(texture_pool.GetColumn<TEXTURE_IMAGE>()[index], stream.format, level - stream.base_mip, stream.source->GetExtent(level), data.data(), data.size());
+            // everything queued since the last flush goes out with the next one
+            stream.pending_value = upload_manager.GetLastSubmittedValue() + 1;
+        }
+        queuedBytes += bytes;
+        queuedAny = true;
     }
+
+    if (queuedAny)
+        texture_stream_value = upload_manager.Flush();
 }
 
-void WRenderer::create_descriptor_pool()
+std::pair<vk::Image, VmaAllocation> WRenderer::create_texture_image(const WKtxTexture& source, const uint32_t baseMip, const bool withinBudget, const std::string_view name)
 {
-    constexpr vk::DescriptorPoolSize descriptorPoolSize {
-        .type = vk::DescriptorType::eUniformBuffer,
-        .descriptorCount = MAX_FRAMES_IN_FLIGHT
+    const vk::Extent2D extent = source.GetExtent(baseMip);
+    const bool concurrent = buffer_queue_families.size() > 1;
+    const vk::ImageCreateInfo imageCI {
+        .imageType = vk::ImageType::e2D,
+        .format = source.GetFormat(),
+        .extent = {extent.width, extent.height, 1},
+        .mipLevels = source.GetLevelCount() - baseMip,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        // written on the transfer queue and sampled on the graphics queue without handing it over
+        .sharingMode = concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(buffer_queue_families.size()) : 0u,
+        .pQueueFamilyIndices = concurrent ? buffer_queue_families.data() : nullptr,
+        .initialLayout = vk::ImageLayout::eUndefined
     };
-    // ReSharper disable once CppVariableCanBeMadeConstexpr
-    const vk::DescriptorPoolCreateInfo descriptorPoolCI {
-        .maxSets = MAX_FRAMES_IN_FLIGHT,
-        .poolSizeCount = 1,
-        .pPoolSizes = &descriptorPoolSize
+    const VmaAllocationCreateInfo allocationCI {
+        .flags = withinBudget ? VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT : 0u,
+        .usage = VMA_MEMORY_USAGE_AUTO
     };
-    descriptor_pool = {device, descriptorPoolCI};
+    VkImage image;
+    VmaAllocation allocation;
+    if (vmaCreateImage(allocator, &*imageCI, &allocationCI, &image, &allocation, nullptr) != VK_SUCCESS)
+        return {nullptr, nullptr};
+    allocation_tracker.Track(allocation, ALLOCATION_TEXTURE, name);
+    return {image, allocation};
 }
 
-void WRenderer::create_descriptor_sets()
+bool WRenderer::begin_texture_rebuild(const uint32_t textureIndex)
 {
-    // TODO: implement descriptor sets, and check if there is vma implementation
-    std::vector layouts(MAX_FRAMES_IN_FLIGHT, *descriptor_set_layout);
-    const vk::DescriptorSetAllocateInfo descriptorSetAllocI {
-        .descriptorPool = descriptor_pool,
-        .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
-        .pSetLayouts = layouts.data(),
-    };
+    auto& stream = texture_pool.GetColumn<TEXTURE_STREAM>()[textureIndex];
+    const uint32_t baseMip = stream.target_mip;
+
+    // growing must not take VMA past the driver budget, shrinking has to go through to give anything back
+    const std::string name = allocation_tracker.Find(texture_pool.GetColumn<TEXTURE_ALLOCATION>()[textureIndex]).name;
+    const auto [image, allocation] = create_texture_image(*stream.source, baseMip, baseMip < stream.base_mip, name);
+    if (!image)
+    {
+        stream.target_mip = stream.base_mip;
+        return false;
+    }
+
+    // the resident levels come from the mapping again, the old image is sampled until they're up
+    for (uint32_t level = std::max(stream.resident_mip, baseMip); level < stream.level_count; level++)
+    {
+        const std::span<const std::byte> data = stream.source->GetLevel(level);
+        upload_manager.EnqueueImageUpload(image, stream.format, level - baseMip, stream.source->GetExtent(level), data.data(), data.size());
+    }
+    stream.rebuild_image = image;
+    stream.rebuild_allocation = allocation;
+    stream.rebuild_base_mip = baseMip;
+    stream.rebuild_value = upload_manager.GetLastSubmittedValue() + 1;
+    return true;
+}
 
-    descriptor_sets.clear();
-    descriptor_sets = device.allocateDescriptorSets(descriptorSetAllocI);
+void WRenderer::finish_texture_rebuild(const uint32_t textureIndex)
+{
+    auto& stream = texture_pool.GetColumn<TEXTURE_STREAM>()[textureIndex];
+    auto& image = texture_pool.GetColumn<TEXTURE_IMAGE>()[textureIndex];
+    auto& allocation = texture_pool.GetColumn<TEXTURE_ALLOCATION>()[textureIndex];
+    const vk::Image oldImage = image;
+    const VmaAllocation oldAllocation = allocation;
+
+    image = stream.rebuild_image;
+    allocation = stream.rebuild_allocation;
+    stream.base_mip = stream.rebuild_base_mip;
+    stream.rebuild_image = nullptr;
+    stream.rebuild_allocation = nullptr;
+    stream.rebuild_value = 0;
+    update_texture_view(textureIndex, std::max(stream.resident_mip, stream.base_mip));
+
+    // counted as free from now on, so the residency manager doesn't shrink something else while the frames in flight finish with it
+    VmaAllocationInfo allocationI;
+    vmaGetAllocationInfo(allocator, oldAllocation, &allocationI);
+    residency_manager.BeginRelease(allocationI.size);
+    deletion_queue.Push(frame_timeline_value + 1, [this, oldImage, oldAllocation, size = allocationI.size] {
+        allocation_tracker.DestroyImage(oldImage, oldAllocation);
+        residency_manager.EndRelease(size);
+    });
+}
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+void WRenderer::release_texture_images(const vk::Image image, const VmaAllocation allocation, const vk::Image rebuildImage, const VmaAllocation rebuildAllocation, const uint64_t uploadValue)
+{
+    // waiting here would stall the frame that collects the deletion on the transfer queue
+    if (uploadValue > upload_manager.GetCompletedValue())
     {
-        vk::DescriptorBufferInfo bufferInfo {
-            .buffer = uniform_buffers[i],
-            .offset = 0,
-            .range = sizeof(UniformBufferObject),
-        };
+        deletion_queue.Push(frame_timeline_value + 1, [=, this] {
+            release_texture_images(image, allocation, rebuildImage, rebuildAllocation, uploadValue);
+        });
+        return;
     }
+
+    allocation_tracker.DestroyImage(image, allocation);
+    if (rebuildImage)
+        allocation_tracker.DestroyImage(rebuildImage, rebuildAllocation);
 }
 
-void create_buffer(const VmaAllocator& _allocator, const vk::DeviceSize size, const vk::BufferUsageFlags usage, const VmaMemoryUsage memoryUsage, vk::Buffer& buffer, VmaAllocation& allocation)
+void WRenderer::update_texture_view(const uint32_t textureIndex, const uint32_t residentMip)
 {
-    const vk::BufferCreateInfo bufferCI{
-        .sType = vk::StructureType::eBufferCreateInfo,
-        .size = size,
-        .usage = usage,
-        .sharingMode = vk::SharingMode::eExclusive
-    };
+    auto& stream = texture_pool.GetColumn<TEXTURE_STREAM>()[textureIndex];
+    auto& view = texture_pool.GetColumn<TEXTURE_VIEW>()[textureIndex];
+    auto& bindlessIndex = texture_pool.GetColumn<TEXTURE_INDEX>()[textureIndex];
 
-    const VmaAllocationCreateInfo memoryAllocationCI {
-        .usage = memoryUsage,
+    // the mips below the resident one are undefined, so the view leaves them out instead of clamping the lod in the shader
+    const vk::ImageViewCreateInfo imageViewCI {
+        .image = texture_pool.GetColumn<TEXTURE_IMAGE>()[textureIndex],
+        .viewType = vk::ImageViewType::e2D,
+        .format = stream.format,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, residentMip - stream.base_mip, stream.level_count - residentMip, 0, 1}
     };
-    vmaCreateBuffer(
-        _allocator,
-        &*bufferCI,
-        &memoryAllocationCI,
-        reinterpret_cast<VkBuffer*>(&buffer),
-        &allocation,
-        nullptr
-    );
+    vk::raii::ImageView newView(device, imageViewCI);
+    const WBindlessIndex newIndex = bindless_heap.RegisterImage(*newView);
+
+    // frames in flight still sample through the old descriptor, it's retired with them
+    if (bindlessIndex != INVALID_BINDLESS_INDEX)
+        UnregisterImage(bindlessIndex);
+    if (view)
+        deletion_queue.Release(frame_timeline_value + 1, vk::raii::ImageView(device, view));
+
+    view = newView.release();
+    bindlessIndex = newIndex;
+    stream.resident_mip = residentMip;
 }
 
-void WRenderer::create_sync_object()
+void WRenderer::build_draw_batches()
 {
-    assert(present_complete_semaphores.empty() && render_finished_semaphores.empty() && in_flight_fences.empty());
+    draw_batches.clear();
+    if (draw_list.empty())
+        return;
+
+    const vk::Pipeline defaultPipeline = pipeline_pool.Get<PIPELINE_HANDLE>(graphics_pipeline);
+    const auto& meshDraws = mesh_pool.GetColumn<MESH_DRAW>();
+    bool needsSort = false;
+    for (auto& draw : draw_list)
+    {
+        draw.pipeline = defaultPipeline;
+        draw.index_type = meshDraws[draw.mesh_index].index_type;
+        needsSort |= draw.index_type != vk::IndexType::eUint32;
+        if (!draw.material) continue;
+
+        // a material destroyed after its draws were queued is treated like a pending one
+        const vk::Pipeline pipeline = material_pool.IsValid(draw.material) ? material_pool.Get<MATERIAL_PIPELINE>(draw.material) : nullptr;
+        if (pipeline)
+        {
+            draw.pipeline = pipeline;
+            needsSort = true;
+        }
+        else if (pending_pipeline_policy == PENDING_PIPELINE_SKIP)
+            draw.pipeline = nullptr;
+    }
+    if (pending_pipeline_policy == PENDING_PIPELINE_SKIP)
+        std::erase_if(draw_list, [](const WDrawCommand& draw) { return !draw.pipeline; });
 
-    for (size_t i = 0; i < swap_chain_images.size(); i++)
-        render_finished_semaphores.emplace_back(device, vk::SemaphoreCreateInfo());
+    // stable, so draws keep their submission order within a batch. Without materials or 16 bit meshes there's nothing to sort
+    if (needsSort)
+        std::ranges::stable_sort(draw_list, {}, [](const WDrawCommand& draw) { return std::pair(static_cast<VkPipeline>(draw.pipeline), draw.index_type); });
 
-    constexpr vk::FenceCreateInfo fenceCI {
-        .flags = vk::FenceCreateFlagBits::eSignaled
-    };
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (uint32_t i = 0; i < draw_list.size(); i++)
     {
-        present_complete_semaphores.emplace_back(device, vk::SemaphoreCreateInfo());
-        in_flight_fences.emplace_back(device, fenceCI);
+        if (draw_batches.empty() || draw_batches.back().pipeline != draw_list[i].pipeline || draw_batches.back().index_type != draw_list[i].index_type)
+            draw_batches.push_back({.pipeline = draw_list[i].pipeline, .index_type = draw_list[i].index_type, .first_draw = i});
+        draw_batches.back().draw_count++;
     }
 }
 
-void WRenderer::update_uniform_buffers(const uint32_t currentImage) const
+void WRenderer::write_gpu_objects()
 {
-    static const auto startTime = std::chrono::high_resolution_clock::now();
+    if (draw_list.empty())
+        return;
 
-    const auto currentTime = std::chrono::high_resolution_clock::now();
-    const float time = std::chrono::duration<float>(currentTime - startTime).count();
+    vk::DeviceAddress instancesAddress = 0;
+    if (!instance_list.empty())
+    {
+        const WFrameSlice instanceSlice = frame_allocator.Allocate(instance_list.size() * sizeof(InstanceData));
+        memcpy(instanceSlice.mapped, instance_list.data(), instance_list.size() * sizeof(InstanceData));
+        instancesAddress = instanceSlice.address;
+    }
 
-    UniformBufferObject ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.view = glm::lookAt(glm::vec3(2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.projection = glm::perspective(glm::radians(45.0f), static_cast<float>(swap_chain_extent.width) / static_cast<float>(swap_chain_extent.height), 0.01f, 10.0f);
+    const WFrameSlice slice = frame_allocator.Allocate(draw_list.size() * sizeof(GpuObject));
+    auto* objects = static_cast<GpuObject*>(slice.mapped);
+    const auto& meshDraws = mesh_pool.GetColumn<MESH_DRAW>();
+    uint32_t batch = 0;
+    for (uint32_t i = 0; i < draw_list.size(); i++)
+    {
+        if (i == draw_batches[batch].first_draw + draw_batches[batch].draw_count)
+            batch++;
+
+        const auto& draw = draw_list[i];
+        const WMeshDraw& meshDraw = meshDraws[draw.mesh_index];
+        WBindlessIndex texture = INVALID_BINDLESS_INDEX;
+        if (draw.material && material_pool.IsValid(draw.material))
+            if (const WTextureHandle materialTexture = material_pool.Get<MATERIAL_TEXTURE>(draw.material); texture_pool.IsValid(materialTexture))
+            {
+                texture = texture_pool.Get<TEXTURE_INDEX>(materialTexture);
+                // the value this frame signals, what the residency manager ranks textures by
+                texture_pool.Get<TEXTURE_STREAM>(materialTexture).last_used = frame_timeline_value + 1;
+            }
+
+        objects[i] = {
+            .model = draw.transform,
+            .bounding_sphere = draw.bounding_sphere,
+            .index_count = meshDraw.index_count,
+            .first_index = meshDraw.first_index,
+            .vertex_offset = meshDraw.vertex_offset,
+            .instance_count = std::max(draw.instance_count, 1u),
+            .instances = draw.instance_count > 0 ? instancesAddress + draw.first_instance * sizeof(InstanceData) : 0,
+            .batch = batch,
+            .batch_first = draw_batches[batch].first_draw,
+            .texture = texture,
+            .sampler = default_sampler_index
+        };
+    }
+    objects_offset = slice.offset;
+}
+
+uint32_t WRenderer::get_mesh_index(const WMeshHandle mesh) const
+{
+    if (!mesh_pool.IsValid(mesh))
+        WThrowException("invalid or destroyed mesh handle");
+
+    return mesh.GetIndex();
+}
+
+WPipelineHandle WRenderer::add_pipeline(vk::raii::Pipeline&& pipeline, const vk::PipelineBindPoint bindPoint)
+{
+    // the pool keeps the plain handle, destroy_pipeline adopts it again
+    const WPipelineHandle handle = pipeline_pool.Allocate(pipeline.release(), bindPoint);
+    if (!handle)
+        WThrowException("out of pipeline handles");
+    return handle;
+}
+
+void WRenderer::destroy_pipeline(WPipelineHandle& pipeline)
+{
+    if (!pipeline_pool.IsValid(pipeline)) return;
 
-    ubo.projection[1][1] *= -1;
+    deletion_queue.Release(frame_timeline_value + 1, vk::raii::Pipeline(device, pipeline_pool.Get<PIPELINE_HANDLE>(pipeline)));
+    pipeline_pool.Free(pipeline);
+    pipeline = {};
+}
 
-    memcpy(uniform_buffers_mapped[currentImage], &ubo, sizeof(ubo));
+void WRenderer::bind_pipeline(const vk::raii::CommandBuffer& commandBuffer, const WPipelineHandle pipeline) const
+{
+    commandBuffer.bindPipeline(pipeline_pool.Get<PIPELINE_BIND_POINT>(pipeline), pipeline_pool.Get<PIPELINE_HANDLE>(pipeline));
 }
 
 void WRenderer::cleanup_swap_chain()
@@ -806,27 +2241,91 @@ void WRenderer::cleanup_swap_chain()
 
     swap_chain_image_views.clear();
     swap_chain = nullptr;
+
+    if (!headless) return;
+
+    for (size_t i = 0; i < offscreen_image_allocs.size(); i++)
+        allocation_tracker.DestroyImage(swap_chain_images[i], offscreen_image_allocs[i]);
+    swap_chain_images.clear();
+    offscreen_image_allocs.clear();
 }
 
 void WRenderer::recreate_swap_chain()
 {
-    int _width = 0, _height = 0;
-    glfwGetWindowSize(window, &_width, &_height);
-    while (_width == 0 || _height == 0)
+    if (headless)
     {
-        glfwGetFramebufferSize(window, &_width, &_height);
-        glfwWaitEvents();
+        retire_swap_chain();
+        create_offscreen_images();
+        create_image_views();
+        return;
     }
 
-    cleanup_swap_chain();
+    // a minimized window has no surface to render to, glfw can only be pumped from the window thread so other threads just wait it out
+    while (framebuffer_width == 0 || framebuffer_height == 0)
+    {
+        if (glfwWindowShouldClose(window))
+            return;
+
+        if (std::this_thread::get_id() == window_thread)
+            glfwWaitEvents();
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
 
-    create_swap_chain();
+    // frames in flight keep rendering to the old images, the new swap chain takes them over through oldSwapchain
+    create_swap_chain(retire_swap_chain());
     create_image_views();
+    create_present_semaphores();
+}
+
+vk::SwapchainKHR WRenderer::retire_swap_chain()
+{
+    // presentation has no completion signal, so the old swap chain is only released once the frames submitted after it are done as well.
+    // by then each of them has acquired from the new swap chain, which the old presents have to finish before
+    const vk::SwapchainKHR oldSwapChain = *swap_chain;
+    const auto retired = std::make_shared<WRetiredSwapChain>();
+    retired->swap_chain = std::move(swap_chain);
+    retired->image_views = std::move(swap_chain_image_views);
+    retired->render_finished_semaphores = std::move(render_finished_semaphores);
+    if (headless)
+    {
+        retired->offscreen_images = std::move(swap_chain_images);
+        retired->offscreen_image_allocs = std::move(offscreen_image_allocs);
+    }
+    deletion_queue.Push(frame_timeline_value + frames_in_flight, [this, retired] {
+        destroy_retired_swap_chain(*retired);
+    });
+
+    swap_chain = nullptr;
+    swap_chain_images.clear();
+    swap_chain_image_views.clear();
+    render_finished_semaphores.clear();
+    offscreen_image_allocs.clear();
+    return oldSwapChain;
+}
+
+void WRenderer::destroy_retired_swap_chain(WRetiredSwapChain& retired) const
+{
+    retired.image_views.clear();
+    retired.render_finished_semaphores.clear();
+    retired.swap_chain = nullptr;
+
+    for (size_t i = 0; i < retired.offscreen_image_allocs.size(); i++)
+        allocation_tracker.DestroyImage(retired.offscreen_images[i], retired.offscreen_image_allocs[i]);
+    retired.offscreen_images.clear();
+    retired.offscreen_image_allocs.clear();
 }
 
-void WRenderer::record_command_buffer(const uint32_t imageIndex) const
+void WRenderer::record_command_buffer(const uint32_t imageIndex)
 {
     command_buffers[frame_index].begin({});
+    profiler.CmdResetQueries(command_buffers[frame_index]);
+    profiler.CmdBeginScope(command_buffers[frame_index], "frame");
+
+    const auto objectCount = static_cast<uint32_t>(draw_list.size());
+    if (gpu_culling && objectCount > 0)
+        record_cull_pass(objectCount);
+
     transition_image_layout(
         imageIndex,
         vk::ImageLayout::eUndefined,
@@ -852,28 +2351,190 @@ void WRenderer::record_command_buffer(const uint32_t imageIndex) const
         .pColorAttachments = &attachmentI,
     };
 
-    command_buffers[frame_index].beginRendering(renderingI);
-    command_buffers[frame_index].bindPipeline(vk::PipelineBindPoint::eGraphics, graphics_pipeline);
-    command_buffers[frame_index].bindVertexBuffers(0, vertex_buffer, {0});
-    command_buffers[frame_index].bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32);
-    command_buffers[frame_index].setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(swap_chain_extent.width), static_cast<float>(swap_chain_extent.height), 0.0f, 1.0f));
-    command_buffers[frame_index].setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), swap_chain_extent));
+    const uint32_t secondaryCount = gpu_culling ? 0 : record_draws_parallel();
 
-    command_buffers[frame_index].drawIndexed(indices.size(), 1, 0, 0, 0);
+    profiler.CmdBeginScope(command_buffers[frame_index], "main pass");
+    if (secondaryCount > 0)
+    {
+        auto secondaryRenderingI = renderingI;
+        secondaryRenderingI.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        command_buffers[frame_index].beginRendering(secondaryRenderingI);
+
+        std::vector<vk::CommandBuffer> secondaries;
+        for (uint32_t i = 0; i < secondaryCount; i++)
+            secondaries.push_back(*record_slots[frame_index * record_thread_count + i].secondary);
+        command_buffers[frame_index].executeCommands(secondaries);
+    }
+    else
+    {
+        command_buffers[frame_index].beginRendering(renderingI);
+        bind_draw_state(command_buffers[frame_index]);
 
+        if (gpu_culling && objectCount > 0)
+        {
+            // every batch was compacted into its own range of the command buffer with its own count
+            const auto& buffers = indirect_buffers[frame_index];
+            vk::IndexType boundIndexType = vk::IndexType::eUint32;
+            for (uint32_t batch = 0; batch < draw_batches.size(); batch++)
+            {
+                command_buffers[frame_index].bindPipeline(vk::PipelineBindPoint::eGraphics, draw_batches[batch].pipeline);
+                if (draw_batches[batch].index_type != boundIndexType)
+                {
+                    boundIndexType = draw_batches[batch].index_type;
+                    geometry_pool.CmdBindIndexBuffer(command_buffers[frame_index], boundIndexType);
+                }
+                command_buffers[frame_index].drawIndexedIndirectCount(
+                    GetBuffer(buffers.commands),
+                    draw_batches[batch].first_draw * sizeof(vk::DrawIndexedIndirectCommand),
+                    GetBuffer(buffers.count),
+                    batch * sizeof(uint32_t),
+                    draw_batches[batch].draw_count,
+                    sizeof(vk::DrawIndexedIndirectCommand)
+                );
+            }
+        }
+        else
+            record_draw_range(command_buffers[frame_index], 0, objectCount);
+    }
     command_buffers[frame_index].endRendering();
+    profiler.CmdEndScope(command_buffers[frame_index]);
+    // headless targets are left ready for a readback copy instead of a present
     transition_image_layout(
         imageIndex,
         vk::ImageLayout::eColorAttachmentOptimal,
-        vk::ImageLayout::ePresentSrcKHR,
+        headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR,
         vk::AccessFlagBits2::eColorAttachmentWrite,
-        {},
+        headless ? vk::AccessFlagBits2::eTransferRead : vk::AccessFlags2{},
         vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-        vk::PipelineStageFlagBits2::eBottomOfPipe
+        headless ? vk::PipelineStageFlagBits2::eTransfer : vk::PipelineStageFlagBits2::eBottomOfPipe
     );
+    profiler.CmdEndScope(command_buffers[frame_index]);
     command_buffers[frame_index].end();
 }
 
+uint32_t WRenderer::record_draws_parallel()
+{
+    const auto drawCount = static_cast<uint32_t>(draw_list.size());
+    const uint32_t taskCount = std::min(record_thread_count, drawCount / MIN_DRAWS_PER_RECORD_TASK);
+    if (taskCount <= 1)
+        return 0;
+
+    const vk::CommandBufferInheritanceRenderingInfo inheritanceRenderingI {
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &swap_chain_image_format,
+        .rasterizationSamples = vk::SampleCountFlagBits::e1
+    };
+    const vk::CommandBufferInheritanceInfo inheritanceI {
+        .pNext = &inheritanceRenderingI
+    };
+    const vk::CommandBufferBeginInfo beginI {
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+        .pInheritanceInfo = &inheritanceI
+    };
+
+    const auto recordTask = [&](const uint32_t task) {
+        const uint32_t firstDraw = drawCount * task / taskCount;
+        const uint32_t lastDraw = drawCount * (task + 1) / taskCount;
+        auto& slot = record_slots[frame_index * record_thread_count + task];
+
+        // frame_slot_values[frame_index] has been reached, so the pool's command buffers can be recycled as a whole
+        slot.pool.reset();
+        slot.secondary.begin(beginI);
+        bind_draw_state(slot.secondary);
+        record_draw_range(slot.secondary, firstDraw, lastDraw - firstDraw);
+        slot.secondary.end();
+    };
+
+    if (parallel_for)
+        parallel_for(taskCount, recordTask);
+    else
+        worker_pool.ParallelFor(taskCount, recordTask);
+
+    return taskCount;
+}
+
+void WRenderer::bind_draw_state(const vk::raii::CommandBuffer& commandBuffer) const
+{
+    bind_pipeline(commandBuffer, graphics_pipeline);
+    commandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(swap_chain_extent.width), static_cast<float>(swap_chain_extent.height), 0.0f, 1.0f));
+    commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), swap_chain_extent));
+
+    geometry_pool.CmdBind(commandBuffer);
+    const std::array descriptorSets {*descriptor_set, bindless_heap.GetSet()};
+    const std::array dynamicOffsets {frame_constants_offset, objects_offset};
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout, 0, descriptorSets, dynamicOffsets);
+}
+
+void WRenderer::record_draw_range(const vk::raii::CommandBuffer& commandBuffer, const uint32_t firstDraw, const uint32_t drawCount) const
+{
+    // the base instance is how the vertex shader finds the object
+    const auto& meshDraws = mesh_pool.GetColumn<MESH_DRAW>();
+    // bind_draw_state left the default pipeline and 32 bit indices bound, the draws are sorted so this only switches once per batch
+    vk::Pipeline boundPipeline = pipeline_pool.Get<PIPELINE_HANDLE>(graphics_pipeline);
+    vk::IndexType boundIndexType = vk::IndexType::eUint32;
+    for (uint32_t i = firstDraw; i < firstDraw + drawCount; i++)
+    {
+        if (draw_list[i].pipeline != boundPipeline)
+        {
+            boundPipeline = draw_list[i].pipeline;
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, boundPipeline);
+        }
+        if (draw_list[i].index_type != boundIndexType)
+        {
+            boundIndexType = draw_list[i].index_type;
+            geometry_pool.CmdBindIndexBuffer(commandBuffer, boundIndexType);
+        }
+
+        const WMeshDraw& meshDraw = meshDraws[draw_list[i].mesh_index];
+        const uint32_t instanceCount = std::max(draw_list[i].instance_count, 1u);
+        commandBuffer.drawIndexed(meshDraw.index_count, instanceCount, meshDraw.first_index, meshDraw.vertex_offset, i);
+    }
+}
+
+void WRenderer::record_cull_pass(const uint32_t objectCount)
+{
+    ensure_indirect_capacity(objectCount);
+    const auto& buffers = indirect_buffers[frame_index];
+    const auto& commandBuffer = command_buffers[frame_index];
+
+    profiler.CmdBeginScope(commandBuffer, "cull");
+    commandBuffer.fillBuffer(GetBuffer(buffers.count), 0, draw_batches.size() * sizeof(uint32_t), 0);
+    constexpr vk::MemoryBarrier2 clearBarrier {
+        .srcStageMask = vk::PipelineStageFlagBits2::eClear,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+    };
+    const vk::DependencyInfo clearDependencyI {
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &clearBarrier
+    };
+    commandBuffer.pipelineBarrier2(clearDependencyI);
+
+    const CullConstants cullConstants {
+        .frustum_planes = frustum_planes,
+        .object_count = objectCount
+    };
+    bind_pipeline(commandBuffer, cull_pipeline);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *cull_pipeline_layout, 0, *cull_descriptor_sets[frame_index], objects_offset);
+    commandBuffer.pushConstants<CullConstants>(*cull_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, cullConstants);
+    // matches numthreads in cull.slang
+    commandBuffer.dispatch((objectCount + 63) / 64, 1, 1);
+
+    constexpr vk::MemoryBarrier2 cullBarrier {
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect,
+        .dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead
+    };
+    const vk::DependencyInfo cullDependencyI {
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &cullBarrier
+    };
+    commandBuffer.pipelineBarrier2(cullDependencyI);
+    profiler.CmdEndScope(commandBuffer);
+}
+
 void WRenderer::transition_image_layout(const uint32_t imageIndex, const vk::ImageLayout oldLayout, const vk::ImageLayout newLayout, const vk::AccessFlags2 srcAccessMask, const vk::AccessFlags2 dstAccessMask, const vk::PipelineStageFlags2 srcStageMask, const vk::PipelineStageFlags2 dstStageMask) const
 {
     constexpr vk::ImageSubresourceRange imgSubresourceRange {
@@ -904,35 +2565,116 @@ void WRenderer::transition_image_layout(const uint32_t imageIndex, const vk::Ima
     command_buffers[frame_index].pipelineBarrier2(dependencyI);
 }
 
+void WRenderer::report_memory_leaks() const
+{
+    if (!allocator) return;
+
+    std::vector<WAllocationTracker::Entry> leaks;
+    buffer_pool.ForEach([&](const WBufferHandle buffer) {
+        leaks.push_back(allocation_tracker.Find(buffer_pool.Get<BUFFER_ALLOCATION>(buffer)));
+    });
+    image_pool.ForEach([&](const WImageHandle image) {
+        leaks.push_back(allocation_tracker.Find(image_pool.Get<IMAGE_ALLOCATION>(image)));
+    });
+    texture_pool.ForEach([&](const WTextureHandle texture) {
+        leaks.push_back(allocation_tracker.Find(texture_pool.Get<TEXTURE_ALLOCATION>(texture)));
+    });
+
+    if (!leaks.empty())
+        std::cerr << leaks.size() << " buffers, images and textures were never destroyed" << std::endl;
+    if (memory_report_path.empty())
+    {
+        for (const auto& leak : leaks)
+            std::cerr << "  " << allocationCategoryName(leak.category) << " " << leak.name << " (" << leak.size << " bytes)" << std::endl;
+        return;
+    }
+
+    // a report that can't be written must not stop the shutdown
+    std::ofstream file(memory_report_path, std::ios::trunc);
+    if (file.is_open())
+        file << allocation_tracker.BuildReport(true, leaks);
+    else
+        std::cerr << "failed to write the memory report to " << memory_report_path.string() << std::endl;
+}
+
 /** This is needed for correct destruction on wayland because the ownership works differently.
     The instance owns the window object, meaning the default destructor of WRenderer causes a segmentation error **/
 void WRenderer::destroy_vulkan()
 {
-    cleanup_swap_chain();
+    shader_hot_reload.Stop();
 
-    in_flight_fences.clear();
+    // waits for the device, so everything that was released is safe to destroy now
+    cleanup_swap_chain();
+    destroy_pipeline(graphics_pipeline);
+    destroy_pipeline(cull_pipeline);
+    for (auto& frameBuffers : indirect_buffers)
+        destroy_indirect_buffers(frameBuffers);
+    indirect_buffers.clear();
+    deletion_queue.Flush();
+    report_memory_leaks();
+    pipeline_library.Destroy();
+    material_pool.Clear();
+    texture_pool.ForEach([this](const WTextureHandle texture) {
+        const vk::raii::ImageView view(device, texture_pool.Get<TEXTURE_VIEW>(texture));
+        allocation_tracker.DestroyImage(texture_pool.Get<TEXTURE_IMAGE>(texture), texture_pool.Get<TEXTURE_ALLOCATION>(texture));
+        if (const WTextureStream& stream = texture_pool.Get<TEXTURE_STREAM>(texture); stream.rebuild_image)
+            allocation_tracker.DestroyImage(stream.rebuild_image, stream.rebuild_allocation);
+    });
+    texture_pool.Clear();
+    default_sampler = nullptr;
+
+    // whatever the owners never destroyed goes with the device
+    buffer_pool.ForEach([this](const WBufferHandle buffer) {
+        allocation_tracker.DestroyBuffer(buffer_pool.Get<BUFFER_HANDLE>(buffer), buffer_pool.Get<BUFFER_ALLOCATION>(buffer));
+    });
+    buffer_pool.Clear();
+    image_pool.ForEach([this](const WImageHandle image) {
+        const vk::raii::ImageView view(device, image_pool.Get<IMAGE_VIEW>(image));
+        allocation_tracker.DestroyImage(image_pool.Get<IMAGE_HANDLE>(image), image_pool.Get<IMAGE_ALLOCATION>(image));
+    });
+    image_pool.Clear();
+    pipeline_pool.Clear();
+
+    frame_timeline = nullptr;
+    frame_slot_values.clear();
     render_finished_semaphores.clear();
     present_complete_semaphores.clear();
 
+    worker_pool.Stop();
+    record_slots.clear();
     command_buffers.clear();
     command_pool.clear();
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-    {
-        vmaUnmapMemory(allocator, uniform_buffer_allocs[i]);
-        vmaDestroyBuffer(allocator, uniform_buffers[i], uniform_buffer_allocs[i]);
-    }
+    profiler.Destroy();
+    upload_manager.Destroy();
+    // the values belong to the upload timeline that was just destroyed
+    texture_stream_value = 0;
+    texture_published_value = 0;
+
+    cull_descriptor_sets.clear();
+    descriptor_set.clear();
+    descriptor_pool.clear();
+    bindless_heap.Destroy();
+    frame_allocator.Destroy();
 
-    vmaDestroyBuffer(allocator, index_buffer, index_buffer_alloc);
-    vmaDestroyBuffer(allocator, vertex_buffer, vertex_buffer_alloc);
+    mesh_pool.Clear();
+    geometry_pool.Destroy();
 
     descriptor_set_layout.clear();
     pipeline_layout.clear();
-    graphics_pipeline.clear();
+    cull_descriptor_set_layout.clear();
+    cull_pipeline_layout.clear();
+
+    save_pipeline_cache();
+    pipeline_cache.clear();
 
     graphics_queue.clear();
     present_queue.clear();
 
+    // anything still tracked here was lost by the renderer itself
+    for (const auto& entry : allocation_tracker.GetTracked())
+        std::cerr << "leaked " << allocationCategoryName(entry.category) << " allocation " << entry.name << " (" << entry.size << " bytes)" << std::endl;
+    allocation_tracker.Destroy();
     vmaDestroyAllocator(allocator);
 
     device.clear();
@@ -946,6 +2688,8 @@ void WRenderer::destroy_vulkan()
 void WRenderer::frame_buffer_resize_callback(GLFWwindow* window, int width, int height)
 {
     const auto app = static_cast<WRenderer*>(glfwGetWindowUserPointer(window));
+    app->framebuffer_width = static_cast<uint32_t>(width);
+    app->framebuffer_height = static_cast<uint32_t>(height);
     app->frame_buffer_resized = true;
 }
 
@@ -965,17 +2709,14 @@ vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormat
     return availableFormats.front();
 }
 
-vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, GLFWwindow* window)
+vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, const vk::Extent2D framebufferExtent)
 {
     if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
         return capabilities.currentExtent;
 
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-
     return {
-        std::clamp<uint32_t>(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
-        std::clamp<uint32_t>(height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height)
+        std::clamp<uint32_t>(framebufferExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
+        std::clamp<uint32_t>(framebufferExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height)
     };
 }
 
@@ -996,18 +2737,15 @@ vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>&
     return vk::PresentModeKHR::eFifo;
 }
 
-std::vector<char> readShaderFile(const std::string &filename)
+bool isPipelineCacheCompatible(const std::vector<char>& cacheData, const vk::PhysicalDeviceProperties& properties)
 {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-    if (!file.is_open()) WRenderer::WThrowException("failed to open file!");
-
-    std::vector<char> buffer(file.tellg());
-    file.seekg(0, std::ios::beg);
-    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-
-    std::cout << buffer.size() << std::endl;
-
-    file.close();
-    return buffer;
+    VkPipelineCacheHeaderVersionOne header;
+    if (cacheData.size() < sizeof(header)) return false;
+    memcpy(&header, cacheData.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == properties.vendorID &&
+        header.deviceID == properties.deviceID &&
+        memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
 }
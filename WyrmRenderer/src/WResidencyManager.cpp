@@ -0,0 +1,84 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WResidencyManager.h"
+
+#include "vk_mem_alloc.h"
+
+#include <algorithm>
+#include <array>
+
+void WResidencyManager::Init(VmaAllocator _allocator, const vk::raii::PhysicalDevice& physicalDevice)
+{
+    allocator = _allocator;
+
+    // on integrated gpus every heap is device local, the budget then covers all of them
+    const auto memoryProperties = physicalDevice.getMemoryProperties();
+    heap_count = memoryProperties.memoryHeapCount;
+    device_local_heaps = 0;
+    for (uint32_t heap = 0; heap < heap_count; heap++)
+        if (memoryProperties.memoryHeaps[heap].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+            device_local_heaps |= 1u << heap;
+
+    usage = 0;
+    budget = 0;
+    releasing = 0;
+    Update();
+}
+
+void WResidencyManager::SetCeiling(const vk::DeviceSize bytes)
+{
+    ceiling = bytes;
+}
+
+void WResidencyManager::Update()
+{
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets {};
+    vmaGetHeapBudgets(allocator, heapBudgets.data());
+
+    usage = 0;
+    budget = 0;
+    for (uint32_t heap = 0; heap < heap_count; heap++)
+    {
+        if (!(device_local_heaps & (1u << heap))) continue;
+        usage += heapBudgets[heap].usage;
+        budget += heapBudgets[heap].budget;
+    }
+    if (ceiling != 0)
+        budget = std::min(budget, ceiling);
+}
+
+void WResidencyManager::BeginRelease(const vk::DeviceSize bytes)
+{
+    releasing += bytes;
+}
+
+void WResidencyManager::EndRelease(const vk::DeviceSize bytes)
+{
+    releasing -= std::min(bytes, releasing);
+}
+
+vk::DeviceSize WResidencyManager::GetUsage() const
+{
+    return usage - std::min(releasing, usage);
+}
+
+vk::DeviceSize WResidencyManager::GetBudget() const
+{
+    return budget;
+}
+
+vk::DeviceSize WResidencyManager::GetExcess() const
+{
+    const vk::DeviceSize used = GetUsage();
+    if (used <= static_cast<vk::DeviceSize>(static_cast<double>(budget) * HIGH_WATERMARK)) return 0;
+    return used - static_cast<vk::DeviceSize>(static_cast<double>(budget) * LOW_WATERMARK);
+}
+
+vk::DeviceSize WResidencyManager::GetHeadroom() const
+{
+    const auto lowWatermark = static_cast<vk::DeviceSize>(static_cast<double>(budget) * LOW_WATERMARK);
+    const vk::DeviceSize used = GetUsage();
+    return used < lowWatermark ? lowWatermark - used : 0;
+}
@@ -0,0 +1,195 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WShaderHotReload.h"
+
+#include <array>
+#include <iostream>
+#include <utility>
+
+#ifdef WYRM_SHADER_HOT_RELOAD
+#include <slang.h>
+#include <slang-com-ptr.h>
+#endif
+
+WShaderHotReload::~WShaderHotReload()
+{
+    Stop();
+}
+
+void WShaderHotReload::Start(const std::filesystem::path& _sourceDirectory, std::vector<WShaderProgram> _programs)
+{
+    if (!IsAvailable()) return;
+
+    Stop();
+    source_directory = _sourceDirectory;
+    programs = std::move(_programs);
+    stopping = false;
+
+    // the first scan only records the current state, the binaries built with the engine are already up to date
+    write_times.clear();
+    scan_sources();
+    watcher = std::thread(&WShaderHotReload::watch_loop, this);
+}
+
+void WShaderHotReload::Stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    if (watcher.joinable())
+        watcher.join();
+}
+
+std::vector<WCompiledShader> WShaderHotReload::TakeCompiled()
+{
+    // checked without the lock, the render loop calls this every frame
+    if (!has_compiled.load(std::memory_order_acquire)) return {};
+
+    std::lock_guard lock(mutex);
+    has_compiled = false;
+    return std::exchange(compiled, {});
+}
+
+bool WShaderHotReload::IsAvailable()
+{
+#ifdef WYRM_SHADER_HOT_RELOAD
+    return true;
+#else
+    return false;
+#endif
+}
+
+void WShaderHotReload::watch_loop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            if (wake.wait_for(lock, POLL_INTERVAL, [this] { return stopping; }))
+                return;
+        }
+
+        // every program is rebuilt on any change, imports make finer tracking not worth it
+        if (scan_sources())
+            compile_all();
+    }
+}
+
+bool WShaderHotReload::scan_sources()
+{
+    std::unordered_map<std::string, std::filesystem::file_time_type> current;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(source_directory, error))
+        if (entry.path().extension() == ".slang")
+            current[entry.path().string()] = entry.last_write_time(error);
+
+    if (error)
+        return false;
+
+    const bool changed = current != write_times;
+    write_times = std::move(current);
+    return changed;
+}
+
+void WShaderHotReload::compile_all()
+{
+#ifdef WYRM_SHADER_HOT_RELOAD
+    // the global session is expensive to create and only ever used from the watcher thread
+    static Slang::ComPtr<slang::IGlobalSession> globalSession;
+    if (!globalSession && SLANG_FAILED(slang::createGlobalSession(globalSession.writeRef())))
+    {
+        std::cerr << "failed to create the slang global session" << std::endl;
+        return;
+    }
+
+    // same flags as the build uses for the embedded shaders
+    std::array options {
+        slang::CompilerOptionEntry {
+            .name = slang::CompilerOptionName::EmitSpirvDirectly,
+            .value = {.kind = slang::CompilerOptionValueKind::Int, .intValue0 = 1}
+        },
+        slang::CompilerOptionEntry {
+            .name = slang::CompilerOptionName::VulkanUseEntryPointName,
+            .value = {.kind = slang::CompilerOptionValueKind::Int, .intValue0 = 1}
+        }
+    };
+    const slang::TargetDesc targetDesc {
+        .format = SLANG_SPIRV,
+        .profile = globalSession->findProfile("spirv_1_4"),
+        .compilerOptionEntries = options.data(),
+        .compilerOptionEntryCount = static_cast<uint32_t>(options.size())
+    };
+    const std::string searchPath = source_directory.string();
+    const char* searchPaths[] = {searchPath.c_str()};
+
+    std::vector<WCompiledShader> results;
+    for (uint32_t i = 0; i < programs.size(); i++)
+    {
+        // a fresh session per program, sessions cache loaded modules and would hand back the stale source
+        slang::SessionDesc sessionDesc {
+            .targets = &targetDesc,
+            .targetCount = 1,
+            .searchPaths = searchPaths,
+            .searchPathCount = 1
+        };
+        Slang::ComPtr<slang::ISession> session;
+        if (SLANG_FAILED(globalSession->createSession(sessionDesc, session.writeRef())))
+            continue;
+
+        Slang::ComPtr<slang::IBlob> diagnostics;
+        const auto printDiagnostics = [&] {
+            if (diagnostics)
+                std::cerr << static_cast<const char*>(diagnostics->getBufferPointer()) << std::endl;
+        };
+
+        slang::IModule* module = session->loadModule(programs[i].module.c_str(), diagnostics.writeRef());
+        printDiagnostics();
+        if (!module) continue;
+
+        std::vector<Slang::ComPtr<slang::IEntryPoint>> entryPoints(programs[i].entry_points.size());
+        std::vector<slang::IComponentType*> components {module};
+        bool found = true;
+        for (size_t e = 0; e < entryPoints.size(); e++)
+        {
+            found &= SLANG_SUCCEEDED(module->findEntryPointByName(programs[i].entry_points[e].c_str(), entryPoints[e].writeRef()));
+            components.push_back(entryPoints[e]);
+        }
+        if (!found)
+        {
+            std::cerr << "shader module " << programs[i].module << " is missing an entry point" << std::endl;
+            continue;
+        }
+
+        Slang::ComPtr<slang::IComponentType> composite;
+        Slang::ComPtr<slang::IComponentType> linked;
+        Slang::ComPtr<slang::IBlob> code;
+        if (SLANG_FAILED(session->createCompositeComponentType(components.data(), static_cast<SlangInt>(components.size()), composite.writeRef(), diagnostics.writeRef())) ||
+            SLANG_FAILED(composite->link(linked.writeRef(), diagnostics.writeRef())) ||
+            SLANG_FAILED(linked->getTargetCode(0, code.writeRef(), diagnostics.writeRef())))
+        {
+            printDiagnostics();
+            continue;
+        }
+
+        const auto* words = static_cast<const uint32_t*>(code->getBufferPointer());
+        results.push_back({i, std::vector(words, words + code->getBufferSize() / sizeof(uint32_t))});
+        std::cout << "reloaded shader " << programs[i].module << std::endl;
+    }
+
+    if (results.empty()) return;
+
+    std::lock_guard lock(mutex);
+    for (auto& result : results)
+    {
+        // a newer build of the same program replaces one the renderer hasn't picked up yet
+        std::erase_if(compiled, [&](const WCompiledShader& pending) { return pending.program == result.program; });
+        compiled.push_back(std::move(result));
+    }
+    has_compiled.store(true, std::memory_order_release);
+#endif
+}
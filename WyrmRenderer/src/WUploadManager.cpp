@@ -0,0 +1,300 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WUploadManager.h"
+
+#include "vk_mem_alloc.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "WRenderer.h"
+
+void WUploadManager::Init(const vk::raii::Device& _device, VmaAllocator _allocator, WAllocationTracker& _tracker, const uint32_t _queueFamilyIndex, const vk::DeviceSize stagingSize)
+{
+    device = &_device;
+    allocator = _allocator;
+    tracker = &_tracker;
+    queue_family_index = _queueFamilyIndex;
+
+    queue = _device.getQueue(queue_family_index, 0);
+
+    const vk::CommandPoolCreateInfo poolCI {
+        .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        .queueFamilyIndex = queue_family_index
+    };
+    command_pool = {_device, poolCI};
+
+    const vk::CommandBufferAllocateInfo allocateI {
+        .commandPool = command_pool,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = BATCH_COUNT
+    };
+    command_buffers = vk::raii::CommandBuffers(_device, allocateI);
+
+    vk::SemaphoreTypeCreateInfo timelineCI {
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0
+    };
+    timeline = {_device, vk::SemaphoreCreateInfo {.pNext = &timelineCI}};
+
+    const vk::BufferCreateInfo bufferCI {
+        .size = stagingSize,
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .sharingMode = vk::SharingMode::eExclusive
+    };
+    constexpr VmaAllocationCreateInfo allocationCI {
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO
+    };
+    VmaAllocationInfo allocationI;
+    if (const VkResult result = vmaCreateBuffer(allocator, &*bufferCI, &allocationCI, reinterpret_cast<VkBuffer*>(&staging_buffer), &staging_allocation, &allocationI); result != VK_SUCCESS)
+        WRenderer::WThrowException("failed to create the upload staging ring: " + vk::to_string(static_cast<vk::Result>(result)));
+    tracker->Track(staging_allocation, ALLOCATION_STAGING, "upload staging ring");
+
+    staging_mapped = static_cast<std::byte*>(allocationI.pMappedData);
+    staging_capacity = stagingSize;
+}
+
+void WUploadManager::Destroy()
+{
+    if (!device) return;
+
+    WaitForValue(last_submitted_value);
+    in_flight.clear();
+    pending_copies.clear();
+    pending_image_copies.clear();
+
+    tracker->DestroyBuffer(staging_buffer, staging_allocation);
+    staging_buffer = nullptr;
+    staging_allocation = nullptr;
+    staging_mapped = nullptr;
+
+    timeline.clear();
+    command_buffers.clear();
+    command_pool.clear();
+    queue.clear();
+    device = nullptr;
+}
+
+void WUploadManager::EnqueueBufferUpload(const vk::Buffer dstBuffer, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size)
+{
+    // big uploads are split so that a part of them can already be copied while the rest waits for ring space
+    const vk::DeviceSize chunkLimit = staging_capacity / 4;
+    auto bytes = static_cast<const std::byte*>(data);
+
+    while (size > 0)
+    {
+        const vk::DeviceSize chunk = std::min(size, chunkLimit);
+        const vk::DeviceSize stagingOffset = allocate_staging(chunk);
+
+        memcpy(staging_mapped + stagingOffset, bytes, chunk);
+        vmaFlushAllocation(allocator, staging_allocation, stagingOffset, chunk);
+        pending_copies.push_back({dstBuffer, stagingOffset, dstOffset, chunk});
+
+        bytes += chunk;
+        dstOffset += chunk;
+        size -= chunk;
+    }
+}
+
+void WUploadManager::EnqueueImageUpload(const vk::Image dstImage, const vk::Format format, const uint32_t mipLevel, const vk::Extent2D extent, const void* data, const vk::DeviceSize size)
+{
+    const auto blockExtent = vk::blockExtent(format);
+    const vk::DeviceSize rowBytes = static_cast<vk::DeviceSize>((extent.width + blockExtent[0] - 1) / blockExtent[0]) * vk::blockSize(format);
+    const uint32_t blockRows = (extent.height + blockExtent[1] - 1) / blockExtent[1];
+    if (rowBytes * blockRows != size)
+        WRenderer::WThrowException("image data doesn't match the extent of its mip level");
+    if (rowBytes > staging_capacity)
+        WRenderer::WThrowException("a row of the image doesn't fit in the staging ring");
+    // buffer offsets of image copies have to be a multiple of the texel block, staging offsets are 16 byte aligned
+    if (16 % vk::blockSize(format) != 0)
+        WRenderer::WThrowException("can't stage images in " + vk::to_string(format));
+
+    const auto rowsPerChunk = static_cast<uint32_t>(std::max<vk::DeviceSize>(staging_capacity / 4 / rowBytes, 1));
+    auto bytes = static_cast<const std::byte*>(data);
+    for (uint32_t row = 0; row < blockRows; row += rowsPerChunk)
+    {
+        const uint32_t rows = std::min(rowsPerChunk, blockRows - row);
+        const vk::DeviceSize chunk = rows * rowBytes;
+        const vk::DeviceSize stagingOffset = allocate_staging(chunk);
+
+        memcpy(staging_mapped + stagingOffset, bytes, chunk);
+        vmaFlushAllocation(allocator, staging_allocation, stagingOffset, chunk);
+
+        const uint32_t y = row * blockExtent[1];
+        pending_image_copies.push_back({
+            .dst_image = dstImage,
+            .region = {
+                .bufferOffset = stagingOffset,
+                .imageSubresource = {vk::ImageAspectFlagBits::eColor, mipLevel, 0, 1},
+                .imageOffset = {0, static_cast<int32_t>(y), 0},
+                .imageExtent = {extent.width, std::min(rows * blockExtent[1], extent.height - y), 1}
+            },
+            .first = row == 0,
+            .last = row + rows == blockRows
+        });
+        bytes += chunk;
+    }
+}
+
+uint64_t WUploadManager::Flush()
+{
+    release_completed(false);
+    if (pending_copies.empty() && pending_image_copies.empty()) return last_submitted_value;
+
+    const uint32_t batch = next_command_buffer;
+    next_command_buffer = (next_command_buffer + 1) % BATCH_COUNT;
+    WaitForValue(command_buffer_values[batch]);
+
+    const auto& commandBuffer = command_buffers[batch];
+    commandBuffer.reset();
+    commandBuffer.begin(vk::CommandBufferBeginInfo {.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+
+    // consecutive copies into the same buffer are merged into one command
+    for (size_t i = 0; i < pending_copies.size();)
+    {
+        const vk::Buffer dstBuffer = pending_copies[i].dst_buffer;
+        copy_regions.clear();
+        for (; i < pending_copies.size() && pending_copies[i].dst_buffer == dstBuffer; i++)
+            copy_regions.push_back({pending_copies[i].src_offset, pending_copies[i].dst_offset, pending_copies[i].size});
+
+        commandBuffer.copyBuffer(staging_buffer, dstBuffer, copy_regions);
+    }
+    if (!pending_image_copies.empty())
+        record_image_copies(commandBuffer);
+    commandBuffer.end();
+
+    const uint64_t value = ++last_submitted_value;
+    const vk::CommandBufferSubmitInfo commandBufferSI {.commandBuffer = *commandBuffer};
+    const vk::SemaphoreSubmitInfo signalSI {
+        .semaphore = *timeline,
+        .value = value,
+        .stageMask = vk::PipelineStageFlagBits2::eAllTransfer
+    };
+    const vk::SubmitInfo2 submitI {
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &commandBufferSI,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signalSI
+    };
+    queue.submit2(submitI);
+
+    command_buffer_values[batch] = value;
+    in_flight.push_back({value, ring_head});
+    pending_copies.clear();
+    pending_image_copies.clear();
+
+    return value;
+}
+
+void WUploadManager::WaitForValue(const uint64_t value) const
+{
+    if (value == 0 || GetCompletedValue() >= value) return;
+
+    const vk::SemaphoreWaitInfo waitI {
+        .semaphoreCount = 1,
+        .pSemaphores = &*timeline,
+        .pValues = &value
+    };
+    if (device->waitSemaphores(waitI, UINT64_MAX) != vk::Result::eSuccess)
+        WRenderer::WThrowException("failed to wait for the upload timeline");
+}
+
+uint64_t WUploadManager::GetCompletedValue() const
+{
+    return timeline.getCounterValue();
+}
+
+uint64_t WUploadManager::GetLastSubmittedValue() const
+{
+    return last_submitted_value;
+}
+
+vk::Semaphore WUploadManager::GetTimelineSemaphore() const
+{
+    return *timeline;
+}
+
+uint32_t WUploadManager::GetQueueFamilyIndex() const
+{
+    return queue_family_index;
+}
+
+void WUploadManager::record_image_copies(const vk::raii::CommandBuffer& commandBuffer)
+{
+    // the consumers wait on the timeline, so the transitions don't have to name their stages
+    const auto levelBarrier = [](const PendingImageCopy& copy, const bool toShaderRead) {
+        return vk::ImageMemoryBarrier2 {
+            .srcStageMask = toShaderRead ? vk::PipelineStageFlagBits2::eCopy : vk::PipelineStageFlagBits2::eNone,
+            .srcAccessMask = toShaderRead ? vk::AccessFlagBits2::eTransferWrite : vk::AccessFlags2 {},
+            .dstStageMask = toShaderRead ? vk::PipelineStageFlagBits2::eNone : vk::PipelineStageFlagBits2::eCopy,
+            .dstAccessMask = toShaderRead ? vk::AccessFlags2 {} : vk::AccessFlagBits2::eTransferWrite,
+            .oldLayout = toShaderRead ? vk::ImageLayout::eTransferDstOptimal : vk::ImageLayout::eUndefined,
+            .newLayout = toShaderRead ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image = copy.dst_image,
+            .subresourceRange = {vk::ImageAspectFlagBits::eColor, copy.region.imageSubresource.mipLevel, 1, 0, 1}
+        };
+    };
+
+    image_barriers.clear();
+    for (const auto& copy : pending_image_copies)
+        if (copy.first)
+            image_barriers.push_back(levelBarrier(copy, false));
+    if (!image_barriers.empty())
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo {.imageMemoryBarrierCount = static_cast<uint32_t>(image_barriers.size()), .pImageMemoryBarriers = image_barriers.data()});
+
+    // consecutive copies into the same image are merged into one command, like the buffer copies
+    for (size_t i = 0; i < pending_image_copies.size();)
+    {
+        const vk::Image dstImage = pending_image_copies[i].dst_image;
+        image_regions.clear();
+        for (; i < pending_image_copies.size() && pending_image_copies[i].dst_image == dstImage; i++)
+            image_regions.push_back(pending_image_copies[i].region);
+
+        commandBuffer.copyBufferToImage(staging_buffer, dstImage, vk::ImageLayout::eTransferDstOptimal, image_regions);
+    }
+
+    image_barriers.clear();
+    for (const auto& copy : pending_image_copies)
+        if (copy.last)
+            image_barriers.push_back(levelBarrier(copy, true));
+    if (!image_barriers.empty())
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo {.imageMemoryBarrierCount = static_cast<uint32_t>(image_barriers.size()), .pImageMemoryBarriers = image_barriers.data()});
+}
+
+vk::DeviceSize WUploadManager::allocate_staging(const vk::DeviceSize size)
+{
+    // copy offsets only need to be 4 byte aligned, 16 keeps memcpy on its fast path
+    uint64_t start = (ring_head + 15) & ~15ull;
+    if (start % staging_capacity + size > staging_capacity)
+        start = (start / staging_capacity + 1) * staging_capacity;
+
+    while (start + size - ring_tail > staging_capacity)
+    {
+        // the space is still held by copies that were never submitted
+        if (in_flight.empty())
+            Flush();
+        release_completed(true);
+    }
+
+    ring_head = start + size;
+    return start % staging_capacity;
+}
+
+void WUploadManager::release_completed(const bool waitForOldest)
+{
+    if (in_flight.empty()) return;
+    if (waitForOldest)
+        WaitForValue(in_flight.front().timeline_value);
+
+    const uint64_t completed = GetCompletedValue();
+    while (!in_flight.empty() && in_flight.front().timeline_value <= completed)
+    {
+        ring_tail = in_flight.front().ring_end;
+        in_flight.pop_front();
+    }
+}
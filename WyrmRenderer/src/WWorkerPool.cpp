@@ -0,0 +1,98 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WWorkerPool.h"
+
+WWorkerPool::~WWorkerPool()
+{
+    Stop();
+}
+
+void WWorkerPool::Start(const uint32_t workerCount)
+{
+    Stop();
+
+    stopping = false;
+    for (uint32_t i = 0; i < workerCount; i++)
+        workers.emplace_back(&WWorkerPool::worker_loop, this);
+}
+
+void WWorkerPool::Stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void WWorkerPool::ParallelFor(const uint32_t count, const std::function<void(uint32_t index)>& task)
+{
+    if (count == 0) return;
+    if (workers.empty() || count == 1)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    {
+        // a worker that woke up late may still be looking at the last batch
+        std::unique_lock lock(mutex);
+        done.wait(lock, [this] { return active_workers == 0; });
+
+        current_task = &task;
+        task_count = count;
+        next_index = 0;
+        finished_count = 0;
+        generation++;
+    }
+    wake.notify_all();
+
+    run_tasks();
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return finished_count == task_count; });
+}
+
+void WWorkerPool::worker_loop()
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+
+            seenGeneration = generation;
+            active_workers++;
+        }
+
+        run_tasks();
+
+        {
+            std::lock_guard lock(mutex);
+            active_workers--;
+        }
+        done.notify_all();
+    }
+}
+
+void WWorkerPool::run_tasks()
+{
+    for (uint32_t i = next_index.fetch_add(1); i < task_count; i = next_index.fetch_add(1))
+    {
+        (*current_task)(i);
+        if (finished_count.fetch_add(1) + 1 == task_count)
+        {
+            std::lock_guard lock(mutex);
+            done.notify_all();
+        }
+    }
+}
@@ -3,17 +3,49 @@
 //
 #pragma once
 
-class WRenderer;
+#include <atomic>
+#include <cstdint>
+#include <exception>
+
+#include "WJobSystem.h"
+#include "WRenderSnapshot.h"
+#include "WTripleBuffer.h"
+
 class WEngine
 {
 public:
     WEngine();
+    ~WEngine();
 
     void Run();
 
     void SetWindowSize(int width, int height) const;
+    void SetHeadless(bool headless) const;
+    void SetFramesInFlight(uint32_t count) const;
+    /** Stops Run after the given amount of frames, 0 means run until the window is closed **/
+    void SetFrameLimit(uint64_t frameLimit);
+    /** Runs the simulation on the calling thread and the renderer on its own thread, frame N is drawn while N + 1 is simulated **/
+    void SetPipelined(bool pipelined);
+
+    /** Shared by the engine systems and the renderer, jobs may be submitted from any thread **/
+    [[nodiscard]] WJobSystem& GetJobSystem();
 
 private:
      WRenderer& renderer;
+     WJobSystem job_system;
+
+     uint64_t frame_limit = 0;
+     bool pipelined = false;
+
+     // stored into either counter once its side stops, so the other one never waits on it forever
+     static constexpr uint64_t PIPELINE_CLOSED = UINT64_MAX;
+     WTripleBuffer<WRenderSnapshot> snapshots;
+     std::atomic<uint64_t> published_frames = 0;
+     std::atomic<uint64_t> consumed_frames = 0;
+     std::exception_ptr render_error;
 
-};
\ No newline at end of file
+     void simulate(WRenderSnapshot& snapshot, WMeshHandle quad, float time) const;
+     void run_serial(WMeshHandle quad);
+     void run_pipelined(WMeshHandle quad);
+     void render_loop();
+};
@@ -0,0 +1,116 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WJobCounter;
+
+struct WJob
+{
+    void (*function)(void* data, uint32_t begin, uint32_t end) = nullptr;
+    void* data = nullptr;
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    WJobCounter* counter = nullptr;
+};
+
+/** Counts the unfinished jobs of a batch, jobs can be queued to start once it drops to zero.
+    Has to outlive every job that was submitted against it **/
+class WJobCounter
+{
+public:
+    [[nodiscard]] bool IsDone() const;
+
+private:
+    friend class WJobSystem;
+
+    std::atomic<uint32_t> pending = 0;
+    mutable std::mutex mutex;
+    std::vector<WJob> waiting;
+};
+
+/** Work stealing scheduler, every worker owns a Chase-Lev deque and steals from the others once its own runs dry.
+    The thread that calls Start becomes worker 0, it runs jobs whenever it waits on a counter.
+    Threads that aren't workers can still submit, their jobs go through a shared queue. **/
+class WJobSystem
+{
+public:
+    WJobSystem() = default;
+    WJobSystem(const WJobSystem&) = delete;
+    WJobSystem& operator=(const WJobSystem&) = delete;
+    ~WJobSystem();
+
+    /** 0 picks one worker per hardware thread, the calling thread included **/
+    void Start(uint32_t workerCount = 0);
+    void Stop();
+
+    void Run(WJobCounter& counter, std::function<void()> job);
+    /** Queues the job once dependency is done, runs right away if it already is **/
+    void RunAfter(WJobCounter& dependency, WJobCounter& counter, std::function<void()> job);
+    /** Splits [0, count) into jobs of grain indices each and helps until all of them finished **/
+    void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t index)>& task);
+    /** Runs other jobs instead of blocking until the counter drops to zero **/
+    void Wait(const WJobCounter& counter);
+
+    [[nodiscard]] uint32_t GetWorkerCount() const;
+
+private:
+    static constexpr uint32_t DEQUE_CAPACITY = 4096;
+
+    /** Chase-Lev deque with a fixed capacity, only the owner pushes and takes, everyone may steal.
+        The slots are made of relaxed atomics so a steal that loses its race never reads a torn job **/
+    class WorkDeque
+    {
+    public:
+        bool Push(const WJob& job);
+        bool Take(WJob& job);
+        bool Steal(WJob& job);
+
+    private:
+        struct Slot
+        {
+            std::atomic<void (*)(void*, uint32_t, uint32_t)> function = nullptr;
+            std::atomic<void*> data = nullptr;
+            std::atomic<uint64_t> range = 0;
+            std::atomic<WJobCounter*> counter = nullptr;
+        };
+
+        alignas(64) std::atomic<int64_t> top = 0;
+        alignas(64) std::atomic<int64_t> bottom = 0;
+        std::array<Slot, DEQUE_CAPACITY> slots {};
+
+        void store(int64_t index, const WJob& job);
+        void load(int64_t index, WJob& job) const;
+    };
+
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    std::vector<std::thread> workers;
+
+    std::mutex injection_mutex;
+    std::deque<WJob> injection_queue;
+    std::atomic<uint32_t> injection_count = 0;
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+    std::atomic<int64_t> queued_jobs = 0;
+    std::atomic<uint32_t> sleeping_workers = 0;
+    std::atomic<bool> stopping = false;
+
+    void submit(const WJob& job);
+    bool try_run_one(int32_t workerIndex);
+    void execute(const WJob& job);
+    void finish(WJobCounter& counter);
+    void worker_loop(int32_t workerIndex);
+    [[nodiscard]] int32_t current_worker() const;
+};
@@ -0,0 +1,43 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <WRenderer.h>
+
+/** Everything the renderer needs to draw one frame, built by the simulation and only read once it's handed over **/
+struct WRenderSnapshot
+{
+    struct WSnapshotDraw
+    {
+        WMeshHandle mesh;
+        glm::mat4 transform {1.0f};
+    };
+
+    struct WSnapshotInstancedDraw
+    {
+        WMeshHandle mesh;
+        uint32_t first_instance = 0;
+        uint32_t instance_count = 0;
+    };
+
+    uint64_t frame = 0;
+
+    bool has_camera = false;
+    glm::mat4 view {1.0f};
+    glm::mat4 projection {1.0f};
+
+    std::vector<WSnapshotDraw> draws;
+    std::vector<WSnapshotInstancedDraw> instanced_draws;
+    std::vector<InstanceData> instances;
+
+    /** Keeps the capacity of the lists so a reused snapshot doesn't allocate **/
+    void Clear(uint64_t frameNumber);
+
+    void SetCamera(const glm::mat4& _view, const glm::mat4& _projection);
+    void Draw(WMeshHandle mesh, const glm::mat4& transform);
+    void DrawInstanced(WMeshHandle mesh, std::span<const InstanceData> meshInstances);
+
+    /** Hands the snapshot to the renderer, has to run on the thread that calls DrawFrame **/
+    void Submit(WRenderer& renderer) const;
+};
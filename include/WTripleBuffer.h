@@ -0,0 +1,52 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/** Lock free single producer, single consumer exchange of the newest value.
+    The producer fills the write buffer and publishes it, the consumer fetches whatever was published last,
+    neither side ever waits on the other. Buffers keep their contents when they come back, so containers keep their capacity. **/
+template<typename T>
+class WTripleBuffer
+{
+public:
+    /** Producer only **/
+    T& GetWriteBuffer()
+    {
+        return buffers[back];
+    }
+
+    /** Producer only, swaps the write buffer with the shared one, a value the consumer never fetched is dropped **/
+    void Publish()
+    {
+        back = shared.exchange(back | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /** Consumer only, returns false if nothing was published since the last fetch **/
+    bool Fetch()
+    {
+        if (!(shared.load(std::memory_order_relaxed) & DIRTY)) return false;
+
+        front = shared.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /** Consumer only **/
+    [[nodiscard]] const T& GetReadBuffer() const
+    {
+        return buffers[front];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t DIRTY = 0b100;
+
+    std::array<T, 3> buffers {};
+    alignas(64) std::atomic<uint8_t> shared = 1;
+    alignas(64) uint8_t back = 0;
+    alignas(64) uint8_t front = 2;
+};
@@ -3,14 +3,29 @@
 //
 
 #include <iostream>
+#include <string>
+#include <string_view>
 
 #include "WEngine.h"
 
-int main()
+int main(const int argc, char* argv[])
 {
     WEngine engine;
     engine.SetWindowSize(1920, 1080);
 
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--headless")
+            engine.SetHeadless(true);
+        else if (arg == "--frames" && i + 1 < argc)
+            engine.SetFrameLimit(std::stoull(argv[++i]));
+        else if (arg == "--frames-in-flight" && i + 1 < argc)
+            engine.SetFramesInFlight(std::stoul(argv[++i]));
+        else if (arg == "--pipelined")
+            engine.SetPipelined(true);
+    }
+
     try
     {
         engine.Run();
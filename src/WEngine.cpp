@@ -5,25 +5,177 @@
 #include "WEngine.h"
 
 #include <WRenderer.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
 
 WEngine::WEngine() : renderer(WRenderer::GetInstance())
-{}
+{
+    job_system.Start();
+
+    // command recording runs on the engine workers instead of the renderer's own threads
+    renderer.SetRecordThreadCount(std::min(job_system.GetWorkerCount(), 16u));
+    renderer.SetParallelFor([this](const uint32_t count, const std::function<void(uint32_t)>& task) {
+        job_system.ParallelFor(count, 1, task);
+    });
+}
+
+WEngine::~WEngine()
+{
+    // the renderer outlives the engine
+    renderer.SetParallelFor({});
+}
 
 void WEngine::Run()
 {
     renderer.InitWindow();
     renderer.InitVulkan();
 
-    while (!glfwWindowShouldClose(renderer.GetWindow()))
+    const WMeshHandle quad = renderer.CreateMesh(vertices, indices);
+    if (pipelined)
+        run_pipelined(quad);
+    else
+        run_serial(quad);
+
+    renderer.Cleanup();
+
+    if (render_error)
+        std::rethrow_exception(std::exchange(render_error, nullptr));
+}
+
+void WEngine::simulate(WRenderSnapshot& snapshot, const WMeshHandle quad, const float time) const
+{
+    snapshot.Draw(quad, glm::rotate(glm::mat4(1.0f), time * glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+}
+
+void WEngine::run_serial(const WMeshHandle quad)
+{
+    WRenderSnapshot snapshot;
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t frame = 0; frame_limit == 0 || frame < frame_limit; frame++)
     {
-        glfwPollEvents();
+        if (!renderer.IsHeadless())
+        {
+            if (glfwWindowShouldClose(renderer.GetWindow())) break;
+            glfwPollEvents();
+        }
+
+        snapshot.Clear(frame);
+        simulate(snapshot, quad, std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - startTime).count());
+        snapshot.Submit(renderer);
         renderer.DrawFrame();
     }
+}
 
-    renderer.Cleanup();
+void WEngine::run_pipelined(const WMeshHandle quad)
+{
+    published_frames = 0;
+    consumed_frames = 0;
+    std::thread renderThread(&WEngine::render_loop, this);
+
+    // glfw events have to be pumped on the thread that created the window, so that stays with the simulation
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint64_t frame = 0; frame_limit == 0 || frame < frame_limit; frame++)
+    {
+        if (!renderer.IsHeadless())
+        {
+            if (glfwWindowShouldClose(renderer.GetWindow())) break;
+            glfwPollEvents();
+        }
+
+        WRenderSnapshot& snapshot = snapshots.GetWriteBuffer();
+        snapshot.Clear(frame);
+        simulate(snapshot, quad, std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - startTime).count());
+
+        // stay at most one snapshot ahead, anything further would only be thrown away by the triple buffer
+        uint64_t consumed = consumed_frames.load();
+        while (consumed < frame)
+        {
+            consumed_frames.wait(consumed);
+            consumed = consumed_frames.load();
+        }
+        if (consumed == PIPELINE_CLOSED) break;
+
+        snapshots.Publish();
+        published_frames.store(frame + 1);
+        published_frames.notify_one();
+    }
+
+    published_frames.store(PIPELINE_CLOSED);
+    published_frames.notify_one();
+    renderThread.join();
+}
+
+void WEngine::render_loop()
+{
+    try
+    {
+        uint64_t consumed = 0;
+        while (true)
+        {
+            uint64_t published = published_frames.load();
+            while (published == consumed)
+            {
+                published_frames.wait(published);
+                published = published_frames.load();
+            }
+
+            // a closed pipeline may still have its last snapshot waiting
+            if (!snapshots.Fetch())
+            {
+                if (published == PIPELINE_CLOSED) break;
+                continue;
+            }
+
+            const WRenderSnapshot& snapshot = snapshots.GetReadBuffer();
+            consumed = snapshot.frame + 1;
+
+            // the read buffer is ours until the next fetch, the simulation can already move on to the next frame
+            consumed_frames.store(consumed);
+            consumed_frames.notify_one();
+
+            snapshot.Submit(renderer);
+            renderer.DrawFrame();
+        }
+    }
+    catch (...)
+    {
+        render_error = std::current_exception();
+    }
+
+    consumed_frames.store(PIPELINE_CLOSED);
+    consumed_frames.notify_one();
 }
 
 void WEngine::SetWindowSize(const int width, const int height) const
 {
     renderer.SetWindowSize(width, height);
 }
+
+void WEngine::SetHeadless(const bool headless) const
+{
+    renderer.SetHeadless(headless);
+}
+
+void WEngine::SetFramesInFlight(const uint32_t count) const
+{
+    renderer.SetFramesInFlight(count);
+}
+
+void WEngine::SetFrameLimit(const uint64_t frameLimit)
+{
+    frame_limit = frameLimit;
+}
+
+void WEngine::SetPipelined(const bool _pipelined)
+{
+    pipelined = _pipelined;
+}
+
+WJobSystem& WEngine::GetJobSystem()
+{
+    return job_system;
+}
@@ -0,0 +1,317 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WJobSystem.h"
+
+#include <algorithm>
+
+static thread_local const WJobSystem* currentSystem = nullptr;
+static thread_local int32_t currentWorkerIndex = -1;
+
+bool WJobCounter::IsDone() const
+{
+    return pending.load(std::memory_order_acquire) == 0;
+}
+
+WJobSystem::~WJobSystem()
+{
+    Stop();
+}
+
+void WJobSystem::Start(uint32_t workerCount)
+{
+    Stop();
+
+    if (workerCount == 0)
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    stopping = false;
+    deques.clear();
+    for (uint32_t i = 0; i < workerCount; i++)
+        deques.push_back(std::make_unique<WorkDeque>());
+
+    currentSystem = this;
+    currentWorkerIndex = 0;
+    for (uint32_t i = 1; i < workerCount; i++)
+        workers.emplace_back(&WJobSystem::worker_loop, this, static_cast<int32_t>(i));
+}
+
+void WJobSystem::Stop()
+{
+    {
+        std::lock_guard lock(sleep_mutex);
+        stopping = true;
+    }
+    sleep_condition.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+
+    if (currentSystem == this)
+    {
+        currentSystem = nullptr;
+        currentWorkerIndex = -1;
+    }
+}
+
+void WJobSystem::Run(WJobCounter& counter, std::function<void()> job)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    submit({
+        .function = [](void* data, uint32_t, uint32_t) {
+            const std::unique_ptr<std::function<void()>> function(static_cast<std::function<void()>*>(data));
+            (*function)();
+        },
+        .data = new std::function(std::move(job)),
+        .counter = &counter
+    });
+}
+
+void WJobSystem::RunAfter(WJobCounter& dependency, WJobCounter& counter, std::function<void()> job)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    const WJob wrapped {
+        .function = [](void* data, uint32_t, uint32_t) {
+            const std::unique_ptr<std::function<void()>> function(static_cast<std::function<void()>*>(data));
+            (*function)();
+        },
+        .data = new std::function(std::move(job)),
+        .counter = &counter
+    };
+
+    {
+        // finish drops the count and takes the waiting jobs under the same lock, so a job is never left behind
+        std::lock_guard lock(dependency.mutex);
+        if (dependency.pending.load(std::memory_order_acquire) > 0)
+        {
+            dependency.waiting.push_back(wrapped);
+            return;
+        }
+    }
+    submit(wrapped);
+}
+
+void WJobSystem::ParallelFor(const uint32_t count, uint32_t grain, const std::function<void(uint32_t index)>& task)
+{
+    grain = std::max(grain, 1u);
+    if (count <= grain || deques.size() <= 1)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    WJobCounter counter;
+    const uint32_t jobCount = (count + grain - 1) / grain;
+    counter.pending.store(jobCount, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < jobCount; i++)
+        submit({
+            .function = [](void* data, const uint32_t begin, const uint32_t end) {
+                const auto& function = *static_cast<const std::function<void(uint32_t)>*>(data);
+                for (uint32_t index = begin; index < end; index++)
+                    function(index);
+            },
+            .data = const_cast<std::function<void(uint32_t)>*>(&task),
+            .begin = i * grain,
+            .end = std::min(count, (i + 1) * grain),
+            .counter = &counter
+        });
+
+    Wait(counter);
+}
+
+void WJobSystem::Wait(const WJobCounter& counter)
+{
+    const int32_t worker = current_worker();
+    while (!counter.IsDone())
+    {
+        if (!try_run_one(worker))
+            std::this_thread::yield();
+    }
+
+    // the last finish may still hold the lock, the counter must not die before it lets go
+    std::lock_guard lock(counter.mutex);
+}
+
+uint32_t WJobSystem::GetWorkerCount() const
+{
+    return static_cast<uint32_t>(deques.size());
+}
+
+void WJobSystem::submit(const WJob& job)
+{
+    const int32_t worker = current_worker();
+    if (worker < 0 || !deques[worker]->Push(job))
+    {
+        std::lock_guard lock(injection_mutex);
+        injection_queue.push_back(job);
+        injection_count.fetch_add(1, std::memory_order_release);
+    }
+
+    queued_jobs.fetch_add(1);
+    if (sleeping_workers.load() > 0)
+    {
+        std::lock_guard lock(sleep_mutex);
+        sleep_condition.notify_one();
+    }
+}
+
+bool WJobSystem::try_run_one(const int32_t workerIndex)
+{
+    WJob job;
+    bool found = workerIndex >= 0 && deques[workerIndex]->Take(job);
+
+    const auto dequeCount = static_cast<int32_t>(deques.size());
+    for (int32_t i = 1; !found && i <= dequeCount; i++)
+    {
+        const int32_t victim = (std::max(workerIndex, 0) + i) % dequeCount;
+        if (victim != workerIndex)
+            found = deques[victim]->Steal(job);
+    }
+
+    if (!found && injection_count.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard lock(injection_mutex);
+        if (!injection_queue.empty())
+        {
+            job = injection_queue.front();
+            injection_queue.pop_front();
+            injection_count.fetch_sub(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+
+    queued_jobs.fetch_sub(1);
+    execute(job);
+    return true;
+}
+
+void WJobSystem::execute(const WJob& job)
+{
+    job.function(job.data, job.begin, job.end);
+    if (job.counter)
+        finish(*job.counter);
+}
+
+void WJobSystem::finish(WJobCounter& counter)
+{
+    // only the last job touches the lock, everyone before it just counts down
+    uint32_t pending = counter.pending.load(std::memory_order_relaxed);
+    while (pending > 1)
+    {
+        if (counter.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+            return;
+    }
+
+    std::vector<WJob> released;
+    {
+        std::lock_guard lock(counter.mutex);
+        counter.pending.fetch_sub(1, std::memory_order_acq_rel);
+        released.swap(counter.waiting);
+    }
+    for (const auto& job : released)
+        submit(job);
+}
+
+void WJobSystem::worker_loop(const int32_t workerIndex)
+{
+    currentSystem = this;
+    currentWorkerIndex = workerIndex;
+
+    while (!stopping)
+    {
+        if (try_run_one(workerIndex))
+            continue;
+
+        // a short spin catches jobs that are pushed right behind each other without a round trip through the kernel
+        bool ran = false;
+        for (uint32_t spin = 0; spin < 64 && !ran; spin++)
+        {
+            std::this_thread::yield();
+            ran = try_run_one(workerIndex);
+        }
+        if (ran) continue;
+
+        std::unique_lock lock(sleep_mutex);
+        sleeping_workers.fetch_add(1);
+        sleep_condition.wait(lock, [this] { return stopping || queued_jobs.load() > 0; });
+        sleeping_workers.fetch_sub(1);
+    }
+}
+
+int32_t WJobSystem::current_worker() const
+{
+    return currentSystem == this ? currentWorkerIndex : -1;
+}
+
+bool WJobSystem::WorkDeque::Push(const WJob& job)
+{
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= DEQUE_CAPACITY) return false;
+
+    store(b, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WJobSystem::WorkDeque::Take(WJob& job)
+{
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    load(b, job);
+    if (t < b) return true;
+
+    // the last job, whoever moves top first gets it
+    const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+}
+
+bool WJobSystem::WorkDeque::Steal(WJob& job)
+{
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return false;
+
+    load(t, job);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+void WJobSystem::WorkDeque::store(const int64_t index, const WJob& job)
+{
+    auto& slot = slots[index % DEQUE_CAPACITY];
+    slot.function.store(job.function, std::memory_order_relaxed);
+    slot.data.store(job.data, std::memory_order_relaxed);
+    slot.range.store(static_cast<uint64_t>(job.begin) << 32 | job.end, std::memory_order_relaxed);
+    slot.counter.store(job.counter, std::memory_order_relaxed);
+}
+
+void WJobSystem::WorkDeque::load(const int64_t index, WJob& job) const
+{
+    const auto& slot = slots[index % DEQUE_CAPACITY];
+    const uint64_t range = slot.range.load(std::memory_order_relaxed);
+    job = {
+        .function = slot.function.load(std::memory_order_relaxed),
+        .data = slot.data.load(std::memory_order_relaxed),
+        .begin = static_cast<uint32_t>(range >> 32),
+        .end = static_cast<uint32_t>(range),
+        .counter = slot.counter.load(std::memory_order_relaxed)
+    };
+}
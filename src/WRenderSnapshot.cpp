@@ -0,0 +1,47 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include "WRenderSnapshot.h"
+
+void WRenderSnapshot::Clear(const uint64_t frameNumber)
+{
+    frame = frameNumber;
+    has_camera = false;
+    draws.clear();
+    instanced_draws.clear();
+    instances.clear();
+}
+
+void WRenderSnapshot::SetCamera(const glm::mat4& _view, const glm::mat4& _projection)
+{
+    has_camera = true;
+    view = _view;
+    projection = _projection;
+}
+
+void WRenderSnapshot::Draw(const WMeshHandle mesh, const glm::mat4& transform)
+{
+    draws.push_back({mesh, transform});
+}
+
+void WRenderSnapshot::DrawInstanced(const WMeshHandle mesh, const std::span<const InstanceData> meshInstances)
+{
+    if (meshInstances.empty()) return;
+
+    instanced_draws.push_back({mesh, static_cast<uint32_t>(instances.size()), static_cast<uint32_t>(meshInstances.size())});
+    instances.insert(instances.end(), meshInstances.begin(), meshInstances.end());
+}
+
+void WRenderSnapshot::Submit(WRenderer& renderer) const
+{
+    if (has_camera)
+        renderer.SetCamera(view, projection);
+
+    for (const auto& draw : draws)
+        renderer.Draw(draw.mesh, draw.transform);
+
+    const std::span<const InstanceData> allInstances = instances;
+    for (const auto& draw : instanced_draws)
+        renderer.DrawInstanced(draw.mesh, allInstances.subspan(draw.first_instance, draw.instance_count));
+}
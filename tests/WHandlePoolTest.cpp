@@ -0,0 +1,106 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include <vector>
+
+#include "WHandle.h"
+#include "WTest.h"
+
+using TestHandle = WHandle<struct WTestTag>;
+using TestPool = WHandlePool<TestHandle, uint32_t, float>;
+
+enum TestColumn : size_t
+{
+    TEST_ID,
+    TEST_WEIGHT
+};
+
+static void staleHandleRejected()
+{
+    TestPool pool;
+    const TestHandle first = pool.Allocate(7, 1.f);
+    WCHECK(first);
+    WCHECK(pool.IsValid(first));
+
+    WCHECK(pool.Free(first));
+    WCHECK(!pool.IsValid(first));
+    WCHECK(!pool.Free(first));
+    WCHECK(pool.GetCount() == 0);
+
+    // the slot is reused under a new generation, the old handle must not reach it
+    const TestHandle second = pool.Allocate(9, 2.f);
+    WCHECK(second.GetIndex() == first.GetIndex());
+    WCHECK(second != first);
+    WCHECK(!pool.IsValid(first));
+    WCHECK(!pool.Free(first));
+    WCHECK(pool.IsValid(second));
+    WCHECK(pool.Get<TEST_ID>(second) == 9);
+}
+
+static void nullHandleRejected()
+{
+    TestPool pool;
+    WCHECK(!pool.IsValid({}));
+    WCHECK(!pool.Free({}));
+
+    pool.Allocate(1, 0.f);
+    WCHECK(!pool.IsValid({}));
+    WCHECK(!pool.Free({}));
+    WCHECK(!pool.IsValid(TestHandle::Make(5, 1)));
+}
+
+static void freeResetsColumns()
+{
+    TestPool pool;
+    const TestHandle handle = pool.Allocate(3, 4.f);
+    pool.Free(handle);
+    WCHECK(pool.GetColumn<TEST_ID>()[handle.GetIndex()] == 0);
+    WCHECK(pool.GetColumn<TEST_WEIGHT>()[handle.GetIndex()] == 0.f);
+}
+
+static void generationSkipsNull()
+{
+    TestPool pool;
+    TestHandle previous = pool.Allocate(0, 0.f);
+    bool neverNull = true, previousStale = true;
+    // enough rounds for the generation to wrap around at least once
+    for (uint32_t round = 0; round < 2 * (TestHandle::GENERATION_MASK + 1); round++)
+    {
+        pool.Free(previous);
+        const TestHandle next = pool.Allocate(round, 0.f);
+        neverNull &= static_cast<bool>(next) && next.GetGeneration() != 0;
+        previousStale &= !pool.IsValid(previous);
+        previous = next;
+    }
+    WCHECK(neverNull);
+    WCHECK(previousStale);
+}
+
+static void forEachVisitsLiveHandles()
+{
+    TestPool pool;
+    std::vector<TestHandle> handles;
+    for (uint32_t i = 0; i < 8; i++)
+        handles.push_back(pool.Allocate(i, 0.f));
+    pool.Free(handles[2]);
+    pool.Free(handles[5]);
+
+    std::vector<TestHandle> visited;
+    pool.ForEach([&](const TestHandle handle) { visited.push_back(handle); });
+    WCHECK(visited.size() == 6);
+    WCHECK(pool.GetCount() == 6);
+    for (const TestHandle handle : visited)
+        WCHECK(pool.IsValid(handle));
+}
+
+int main()
+{
+    return runTests({
+        {"Stale handles are rejected after Free", staleHandleRejected},
+        {"Null handles are rejected", nullHandleRejected},
+        {"Free resets the columns", freeResetsColumns},
+        {"Generations skip the null value", generationSkipsNull},
+        {"ForEach visits the live handles", forEachVisitsLiveHandles}
+    });
+}
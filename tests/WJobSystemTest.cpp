@@ -0,0 +1,111 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "WJobSystem.h"
+#include "WTest.h"
+
+static bool coversEveryIndexOnce(WJobSystem& jobs, const uint32_t count, const uint32_t grain)
+{
+    std::vector<std::atomic<uint32_t>> hits(count);
+    jobs.ParallelFor(count, grain, [&](const uint32_t index) {
+        hits[index].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    for (const auto& hit : hits)
+        if (hit.load(std::memory_order_relaxed) != 1)
+            return false;
+    return true;
+}
+
+static void parallelForCoversEveryIndex()
+{
+    WJobSystem jobs;
+    jobs.Start(4);
+
+    WCHECK(coversEveryIndexOnce(jobs, 0, 16));
+    // at most one grain runs inline on the caller
+    WCHECK(coversEveryIndexOnce(jobs, 16, 16));
+    WCHECK(coversEveryIndexOnce(jobs, 1000, 7));
+    // more jobs than a deque holds, the rest spills into the shared queue
+    WCHECK(coversEveryIndexOnce(jobs, 20000, 1));
+
+    // many small batches back to back keep the owner's take and the thieves' steal racing for the last job
+    bool allCovered = true;
+    for (uint32_t round = 0; round < 2000; round++)
+        allCovered &= coversEveryIndexOnce(jobs, 64, 1);
+    WCHECK(allCovered);
+}
+
+static void parallelForFromOtherThread()
+{
+    WJobSystem jobs;
+    jobs.Start(4);
+
+    // a thread that isn't a worker submits through the shared queue and waits without a deque of its own
+    bool covered = false;
+    std::thread outsider([&] {
+        covered = coversEveryIndexOnce(jobs, 5000, 3);
+    });
+    outsider.join();
+    WCHECK(covered);
+}
+
+static void runAfterWaitsForDependency()
+{
+    WJobSystem jobs;
+    jobs.Start(4);
+
+    constexpr uint32_t JOB_COUNT = 16;
+    bool ordered = true;
+    for (uint32_t round = 0; round < 500; round++)
+    {
+        WJobCounter first, second, third;
+        std::atomic<uint32_t> firstDone = 0;
+        std::atomic<bool> secondSawFirst = false, thirdSawSecond = false;
+        std::atomic<bool> secondDone = false;
+
+        for (uint32_t i = 0; i < JOB_COUNT; i++)
+            jobs.Run(first, [&] { firstDone.fetch_add(1, std::memory_order_relaxed); });
+        // queued while the first batch is most likely still running, so finish has to release it
+        jobs.RunAfter(first, second, [&] {
+            secondSawFirst = firstDone.load(std::memory_order_relaxed) == JOB_COUNT;
+            secondDone = true;
+        });
+        jobs.RunAfter(second, third, [&] { thirdSawSecond = secondDone.load(); });
+
+        jobs.Wait(third);
+        jobs.Wait(second);
+        jobs.Wait(first);
+        ordered &= secondSawFirst && thirdSawSecond;
+    }
+    WCHECK(ordered);
+}
+
+static void runAfterFinishedDependency()
+{
+    WJobSystem jobs;
+    jobs.Start(2);
+
+    WJobCounter done, counter;
+    std::atomic<bool> ran = false;
+    WCHECK(done.IsDone());
+    jobs.RunAfter(done, counter, [&] { ran = true; });
+    jobs.Wait(counter);
+    WCHECK(ran);
+    WCHECK(counter.IsDone());
+}
+
+int main()
+{
+    return runTests({
+        {"ParallelFor covers every index once", parallelForCoversEveryIndex},
+        {"ParallelFor from a thread that isn't a worker", parallelForFromOtherThread},
+        {"RunAfter waits for its dependency", runAfterWaitsForDependency},
+        {"RunAfter on a finished dependency", runAfterFinishedDependency}
+    });
+}
@@ -0,0 +1,32 @@
+//
+// Created by pheen on 16/10/2026.
+//
+#pragma once
+
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+
+inline int failedChecks = 0;
+
+/** Keeps going after a failure so one run reports everything that broke **/
+#define WCHECK(condition) \
+    do { \
+        if (!(condition)) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            failedChecks++; \
+        } \
+    } while (false)
+
+/** Runs every test in order and turns the failed checks into the exit code ctest looks at **/
+inline int runTests(const std::initializer_list<std::pair<const char*, void (*)()>> tests)
+{
+    for (const auto& [name, test] : tests)
+    {
+        const int failedBefore = failedChecks;
+        test();
+        std::cout << (failedChecks == failedBefore ? "passed " : "FAILED ") << name << std::endl;
+    }
+    return failedChecks == 0 ? 0 : 1;
+}
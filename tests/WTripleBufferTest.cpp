@@ -0,0 +1,79 @@
+//
+// Created by pheen on 16/10/2026.
+//
+
+#include <array>
+#include <thread>
+
+#include "WTest.h"
+#include "WTripleBuffer.h"
+
+struct Snapshot
+{
+    uint64_t sequence = 0;
+    std::array<uint64_t, 15> payload {};
+};
+
+static void fetchSeesNewestValue()
+{
+    WTripleBuffer<Snapshot> buffer;
+    WCHECK(!buffer.Fetch());
+    WCHECK(buffer.GetReadBuffer().sequence == 0);
+
+    buffer.GetWriteBuffer().sequence = 1;
+    buffer.Publish();
+    buffer.GetWriteBuffer().sequence = 2;
+    buffer.Publish();
+
+    // the value nobody fetched is dropped, only the newest one comes through
+    WCHECK(buffer.Fetch());
+    WCHECK(buffer.GetReadBuffer().sequence == 2);
+    WCHECK(!buffer.Fetch());
+    WCHECK(buffer.GetReadBuffer().sequence == 2);
+}
+
+static void publishAndFetchUnderContention()
+{
+    constexpr uint64_t PUBLISH_COUNT = 500000;
+    WTripleBuffer<Snapshot> buffer;
+
+    std::thread producer([&] {
+        for (uint64_t sequence = 1; sequence <= PUBLISH_COUNT; sequence++)
+        {
+            Snapshot& snapshot = buffer.GetWriteBuffer();
+            snapshot.sequence = sequence;
+            snapshot.payload.fill(sequence);
+            buffer.Publish();
+        }
+    });
+
+    // every fetched buffer has to be whole and newer than the one before
+    bool consistent = true, increasing = true;
+    uint64_t last = 0, fetchCount = 0;
+    while (last < PUBLISH_COUNT)
+    {
+        if (!buffer.Fetch()) continue;
+
+        const Snapshot& snapshot = buffer.GetReadBuffer();
+        for (const uint64_t value : snapshot.payload)
+            consistent &= value == snapshot.sequence;
+        increasing &= snapshot.sequence > last;
+        last = snapshot.sequence;
+        fetchCount++;
+    }
+    producer.join();
+
+    WCHECK(consistent);
+    WCHECK(increasing);
+    WCHECK(last == PUBLISH_COUNT);
+    WCHECK(fetchCount > 0);
+    WCHECK(!buffer.Fetch());
+}
+
+int main()
+{
+    return runTests({
+        {"Fetch sees the newest value", fetchSeesNewestValue},
+        {"Publish and Fetch under contention", publishAndFetchUnderContention}
+    });
+}